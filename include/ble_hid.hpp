@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <vector>
+#include <tuple>
 #include <utility>
 
 namespace knomi {
@@ -63,11 +63,11 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    /*Include the ESP32 PSRAM allocation functions*/
-    #define LV_MEM_CUSTOM_INCLUDE <esp32-hal-psram.h>
-    #define LV_MEM_CUSTOM_ALLOC   ps_malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC ps_realloc
+    /*Small blocks from an internal SRAM slab arena, large ones from PSRAM (src/lvgl_mem.cpp)*/
+    #define LV_MEM_CUSTOM_INCLUDE <lvgl_mem.h>
+    #define LV_MEM_CUSTOM_ALLOC   lvgl_mem_alloc
+    #define LV_MEM_CUSTOM_FREE    lvgl_mem_free
+    #define LV_MEM_CUSTOM_REALLOC lvgl_mem_realloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -89,13 +89,13 @@
 
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
-#define LV_TICK_CUSTOM 0
+#define LV_TICK_CUSTOM 1
 #if LV_TICK_CUSTOM
-    #define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
-    #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
-    /*If using lvgl as ESP32 component*/
-    // #define LV_TICK_CUSTOM_INCLUDE "esp_timer.h"
-    // #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((esp_timer_get_time() / 1000LL))
+    // #define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
+    // #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
+    /*Monotonic esp_timer clock: no 1 kHz tick interrupt, and C-includable (lvgl's own sources use it)*/
+    #define LV_TICK_CUSTOM_INCLUDE "esp_timer.h"
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((uint32_t)(esp_timer_get_time() / 1000LL))
 #endif   /*LV_TICK_CUSTOM*/
 
 /*Default Dot Per Inch. Used to initialize default sizes such as widgets sized, style paddings.
@@ -687,7 +687,7 @@
  *----------*/
 
 /*1: Enable API to take snapshot for object*/
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /*1: Enable Monkey test*/
 #define LV_USE_MONKEY 0
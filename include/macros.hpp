@@ -4,9 +4,19 @@
 namespace macros {
 
 enum class Type { Keystroke, Typing, Keybind, HoldSeq };
+// When a page fires: after a tap (default), at touch-down, or held down for as
+// long as the finger stays (single key combos only; other macros fire at touch-down).
+enum class Trigger { Release, Press, Hold };
+
+// Extra action on a slot; unset while the payload is empty.
+struct Binding {
+  Type type = Type::Keybind;
+  String payload;
+  bool set() const { return payload.length() > 0; }
+};
 
 struct Slot {
-  uint8_t id;
+  uint16_t id;
   String title;
   Type type;
   String payload;   // raw string as user provided
@@ -14,6 +24,13 @@ struct Slot {
   uint32_t bg2 = 0; // secondary color for gradient
   bool gradient = false;
   String iconPath;  // e.g., /icons/1.svg
+  Trigger trigger = Trigger::Release;
+  Binding doubleTap;          // only a slot with this set makes its single taps wait
+  Binding longPress;
+  uint16_t doubleTapMs = 250; // second-tap window
+  // runtime only, assigned by storage (not persisted)
+  uint32_t handle = 0; // stable identity across inserts/deletes
+  uint32_t rev = 0;    // bumped whenever the slot's contents change
 };
 
 bool parse_keystroke(const String& text); // validates only
@@ -24,9 +41,12 @@ void run_keystroke(const String& text);
 void run_typing(const String& text);
 void run_keybind(const String& text);
 void run_holdseq(const String& payload);
+void run_hold(const String& payload, bool down);  // key-down stays until the matching key-up
 
 void begin_async();
 void enqueue(Type type, const String& payload);
+bool can_hold(Type type, const String& payload);  // payload is one key combo
+void enqueue_hold(const String& payload, bool down); // key-down / key-up, in order with enqueue()
 
 inline const char* type_to_string(Type t){
   switch(t){
@@ -46,4 +66,19 @@ inline Type type_from_string(const String& s){
   return Type::Keystroke;
 }
 
+inline const char* trigger_to_string(Trigger t){
+  switch(t){
+    case Trigger::Press: return "press";
+    case Trigger::Hold:  return "hold";
+    default:             return "release";
+  }
+}
+
+inline Trigger trigger_from_string(const String& s){
+  String a=s; a.toLowerCase();
+  if(a=="press") return Trigger::Press;
+  if(a=="hold")  return Trigger::Hold;
+  return Trigger::Release;
+}
+
 } // namespace macros
@@ -24,6 +24,19 @@ CST816S::CST816S(int rst, int irq, TwoWire *Wi) {
  */
 void CST816S::_setReady(void) {
   _ready = true;
+  if (_isr_cb) _isr_cb(_isr_arg);
+}
+
+/*!
+ *  @brief  Register a callback run from the touch interrupt
+ *  @param  cb
+ *          function to call (ISR context: keep it to a task notification)
+ *  @param  arg
+ *          passed through to cb
+ */
+void CST816S::onInterrupt(void (*cb)(void *), void *arg) {
+  _isr_arg = arg;
+  _isr_cb = cb;
 }
 
 /*!
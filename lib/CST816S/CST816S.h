@@ -111,6 +111,7 @@ public:
   bool setLongRst(uint8_t sec);
   bool setDisAutoSleep(uint8_t dissleep);
   bool getTouch(touch_event_t *event);
+  void onInterrupt(void (*cb)(void *), void *arg);
 
 private:
   int _rst;
@@ -118,7 +119,9 @@ private:
   TwoWire *i2c;
   int8_t _i2caddr;
 
-  bool _ready;
+  volatile bool _ready;
+  void (*_isr_cb)(void *) = nullptr;
+  void *_isr_arg = nullptr;
   void _setReady(void);
   void _reset(void);
   bool read_raw(uint8_t reg, uint8_t *data, uint32_t len);
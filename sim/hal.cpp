@@ -0,0 +1,114 @@
+// lvgl_hal.h for the host: LVGL renders into the TFT_eSPI memory panel shim,
+// time is virtual and touch samples come from sim::touch().
+#include "lvgl_hal.h"
+#include "touch.hpp"
+#include "render_stats.hpp"
+#include "sim.hpp"
+#include "backlight.hpp"
+#include <LittleFS.h>
+extern "C" {
+  #include "esp_timer.h"
+}
+
+HardwareSerial Serial;
+EspClass ESP;
+FS LittleFS;
+TFT_eSPI tft_gc9a01;
+
+namespace {
+
+int64_t g_now = 1000000;        // start at 1 s so nothing sees a zero timestamp; LVGL's tick reads it too
+lv_color_t* g_shadow = nullptr;
+void (*g_hook)(const touch::Sample&) = nullptr;
+lv_indev_t* g_indev = nullptr;
+
+// Same as the firmware flush: panel, shadow copy, render stats.
+void flush(lv_disp_drv_t* disp, const lv_area_t* area, lv_color_t* color_p){
+  const uint32_t w = area->x2 - area->x1 + 1;
+  const uint32_t h = area->y2 - area->y1 + 1;
+  const int64_t t0 = esp_timer_get_time();
+
+  tft_gc9a01.startWrite();
+  tft_gc9a01.setAddrWindow(area->x1, area->y1, w, h);
+  tft_gc9a01.pushColors((uint16_t*)&color_p->full, w * h, true);
+  tft_gc9a01.endWrite();
+
+  lv_color_t* dst = g_shadow + area->y1 * TFT_WIDTH + area->x1;
+  for(uint32_t y = 0; y < h; y++) memcpy(dst + y * TFT_WIDTH, color_p + y * w, w * sizeof(lv_color_t));
+
+  render_stats::on_flush((uint32_t)(esp_timer_get_time() - t0));
+  lv_disp_flush_ready(disp);
+}
+
+void touchpad_read(lv_indev_drv_t* drv, lv_indev_data_t* data){
+  static touch::Sample last{};
+  touch::Sample s;
+  if(touch::read(s)){
+    last = s;
+    if(g_hook) g_hook(s);
+    data->continue_reading = touch::pending();
+  }
+  data->point.x = last.x;
+  data->point.y = last.y;
+  data->state = last.down ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+  if(!last.down && !data->continue_reading) lv_timer_pause(drv->read_timer);
+}
+
+} // anon
+
+extern "C" int64_t esp_timer_get_time(void){ return g_now; }
+uint32_t millis(){ return (uint32_t)(g_now / 1000); }
+uint32_t micros(){ return (uint32_t)g_now; }
+void delay(uint32_t ms){ sim::advance_us((int64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us){ sim::advance_us(us); }
+
+namespace sim {
+
+int64_t now_us(){ return g_now; }
+
+void advance_us(int64_t us){ g_now += us; }
+
+} // namespace sim
+
+void lvgl_hal_init(void){
+  tft_gc9a01.begin();
+  tft_gc9a01.fillScreen(TFT_BLACK);
+  tft_set_backlight(16);
+
+  static lv_disp_draw_buf_t draw_buf;
+  static lv_color_t* color_buf = (lv_color_t*)malloc(TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t));
+  if(!g_shadow) g_shadow = (lv_color_t*)calloc(TFT_WIDTH * TFT_HEIGHT, sizeof(lv_color_t));
+  lv_init();
+  lv_disp_draw_buf_init(&draw_buf, color_buf, NULL, TFT_WIDTH * TFT_HEIGHT);
+
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = TFT_WIDTH;
+  disp_drv.ver_res = TFT_HEIGHT;
+  disp_drv.flush_cb = flush;
+  disp_drv.render_start_cb = [](lv_disp_drv_t*){ render_stats::on_render_start(); };
+  disp_drv.monitor_cb = [](lv_disp_drv_t*, uint32_t, uint32_t px){ render_stats::on_frame_done(px); };
+  disp_drv.draw_buf = &draw_buf;
+  lv_disp_drv_register(&disp_drv);
+
+  static lv_indev_drv_t indev_drv;
+  lv_indev_drv_init(&indev_drv);
+  indev_drv.gesture_min_velocity = UINT8_MAX;
+  indev_drv.type = LV_INDEV_TYPE_POINTER;
+  indev_drv.read_cb = touchpad_read;
+  g_indev = lv_indev_drv_register(&indev_drv);
+
+  lv_obj_set_style_bg_color(lv_scr_act(), LV_COLOR_MAKE(0, 0, 0), LV_STATE_DEFAULT);
+}
+
+void tft_set_backlight(int8_t light){ backlight::set(light < 0 ? 0 : (uint8_t)light); }
+
+void lvgl_hal_touch_kick(void){
+  if(!g_indev) return;
+  lv_timer_resume(g_indev->driver->read_timer);
+  lv_timer_ready(g_indev->driver->read_timer);
+}
+
+void lvgl_hal_on_touch(void (*cb)(const touch::Sample&)){ g_hook = cb; }
+
+const lv_color_t* lvgl_hal_framebuffer(void){ return g_shadow; }
@@ -0,0 +1,350 @@
+// Headless UI simulator: runs ui::begin() and the real widgets on the host
+// against a memory panel, renders every page and every swipe transition, and
+// compares each page with a golden image.
+//
+//   pio run -e sim && .pio/build/sim/program [--update] [--reps N] [--tolerance PX]
+//                                            [--golden DIR] [--out DIR]
+//
+// Page rows time a full-screen redraw (ms per frame, bytes pushed to the panel);
+// the clock row is the half-second colon/tick update; swipe rows play the slide
+// from each page in both directions. Time inside the UI is virtual, so frame
+// counts and images are the same on every run. --update rewrites the goldens
+// (sim/golden/page_<n>.ppm); otherwise a page that differs in more than
+// --tolerance pixels, or has no golden, fails the run and its render (and a
+// diff) land in --out.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <LittleFS.h>
+#include "lvgl_hal.h"
+#include "ui.hpp"
+#include "storage.hpp"
+#include "transition.hpp"
+#include "power.hpp"
+#include "sim.hpp"
+
+namespace {
+
+struct Options {
+  bool update = false;
+  int reps = 50;
+  unsigned tolerance = 0;
+  std::string golden = "sim/golden";
+  std::string out = "sim/out";
+};
+
+using Clock = std::chrono::steady_clock;
+double ms_since(Clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// ---- PNG icons for the in-memory LittleFS (stored deflate, no zlib needed) ----
+
+uint32_t crc32(const uint8_t* p, size_t n, uint32_t c = 0) {
+  c = ~c;
+  while (n--) {
+    c ^= *p++;
+    for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+  }
+  return ~c;
+}
+
+void put32(std::vector<uint8_t>& v, uint32_t x) {
+  for (int s = 24; s >= 0; s -= 8) v.push_back((uint8_t)(x >> s));
+}
+
+void chunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+  put32(png, data.size());
+  std::vector<uint8_t> body(type, type + 4);
+  body.insert(body.end(), data.begin(), data.end());
+  png.insert(png.end(), body.begin(), body.end());
+  put32(png, crc32(body.data(), body.size()));
+}
+
+std::vector<uint8_t> encode_png(const std::vector<uint32_t>& rgba, uint32_t w, uint32_t h) {
+  std::vector<uint8_t> raw;
+  for (uint32_t y = 0; y < h; ++y) {
+    raw.push_back(0);   // filter: none
+    for (uint32_t x = 0; x < w; ++x) put32(raw, rgba[y * w + x]);
+  }
+  std::vector<uint8_t> z = {0x78, 0x01};
+  uint32_t a = 1, b = 0;
+  for (uint8_t c : raw) { a = (a + c) % 65521; b = (b + a) % 65521; }
+  for (size_t off = 0; off < raw.size() || off == 0; off += 65535) {
+    const size_t n = std::min<size_t>(65535, raw.size() - off);
+    z.push_back(off + n == raw.size() ? 1 : 0);
+    z.push_back(n & 0xff); z.push_back(n >> 8);
+    z.push_back(~n & 0xff); z.push_back((~n >> 8) & 0xff);
+    z.insert(z.end(), raw.begin() + off, raw.begin() + off + n);
+  }
+  put32(z, (b << 16) | a);
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  std::vector<uint8_t> ihdr;
+  put32(ihdr, w); put32(ihdr, h);
+  ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});   // 8-bit RGBA
+  chunk(png, "IHDR", ihdr);
+  chunk(png, "IDAT", z);
+  chunk(png, "IEND", {});
+  return png;
+}
+
+// Flat white glyphs in the spirit of the stock icons, each exercising a different
+// alpha pattern: solid disc, ring, soft-edged square, stripes.
+std::vector<uint8_t> make_icon(int kind) {
+  const uint32_t n = 120;
+  std::vector<uint32_t> px(n * n, 0);
+  for (uint32_t y = 0; y < n; ++y)
+    for (uint32_t x = 0; x < n; ++x) {
+      const float dx = x - 59.5f, dy = y - 59.5f, r2 = dx * dx + dy * dy;
+      uint8_t alpha = 0;
+      switch (kind) {
+        case 0: alpha = r2 < 50 * 50 ? 255 : 0; break;
+        case 1: alpha = (r2 < 55 * 55 && r2 > 40 * 40) ? 255 : 0; break;
+        case 2: {
+          const float d = std::max(std::fabs(dx), std::fabs(dy));
+          alpha = d < 40 ? 255 : d < 52 ? (uint8_t)(255 * (52 - d) / 12) : 0;
+          break;
+        }
+        default: alpha = ((x + y) / 12) % 2 ? 230 : 0; break;
+      }
+      px[y * n + x] = 0xFFFFFF00u | alpha;
+    }
+  return encode_png(px, n, n);
+}
+
+void write_file(const char* path, const std::vector<uint8_t>& data) {
+  File f = LittleFS.open(path, "w");
+  f.write(data.data(), data.size());
+  f.close();
+}
+
+// Five pages covering solid and gradient backgrounds, every icon kind and no icon,
+// written through storage so the profile file is parsed like on the device.
+void seed_profile() {
+  struct Seed { const char* title; macros::Type type; const char* payload; uint32_t bg, bg2; int icon; };
+  const Seed seeds[] = {
+    {"Copy/Paste", macros::Type::Keystroke, "LCtrl+c, 500ms, LCtrl+v", 0x2D9BF0, 0x2D9BF0, 0},
+    {"Hello",      macros::Type::Typing,    "This is KnomiPad (8/s)",  0x34C759, 0x0A3D1F, 1},
+    {"F12",        macros::Type::Keybind,   "F12",                     0xFF9F0A, 0xFF9F0A, 2},
+    {"Tab",        macros::Type::Keybind,   "Tab",                     0xFF375F, 0x5E0B1E, 3},
+    {"Enter",      macros::Type::Keybind,   "Enter",                   0x8E8E93, 0x8E8E93, -1},
+  };
+  LittleFS.mkdir("/icons");
+  storage::Profile p;
+  for (const Seed& s : seeds) {
+    macros::Slot slot;
+    slot.id = p.slots.size();
+    slot.title = s.title;
+    slot.type = s.type;
+    slot.payload = s.payload;
+    slot.bg = s.bg;
+    slot.bg2 = s.bg2;
+    slot.gradient = s.bg != s.bg2;
+    if (s.icon >= 0) {
+      slot.iconPath = String("/icons/") + s.icon + ".png";
+      write_file(slot.iconPath.c_str(), make_icon(s.icon));
+    }
+    p.slots.push_back(slot);
+  }
+  storage::save(p);
+  storage::load();
+}
+
+// ---- Driving the UI ----
+
+// Advance virtual time in LVGL-task-sized steps.
+void run_for(uint32_t ms, uint32_t step_ms = 5) {
+  for (uint32_t t = 0; t < ms; t += step_ms) {
+    sim::advance_us(step_ms * 1000);
+    ui::pump();
+  }
+}
+
+struct Row {
+  std::string name;
+  unsigned frames;
+  double ms_per_frame;
+  uint64_t bytes;
+};
+
+void print_row(const Row& r) {
+  std::printf("  %-22s %6u frames %8.3f ms/frame %10llu bytes\n", r.name.c_str(), r.frames, r.ms_per_frame,
+              (unsigned long long)r.bytes);
+}
+
+// Full-screen redraw of whatever is visible, `reps` times.
+Row bench_redraw(const std::string& name, int reps) {
+  const uint64_t b0 = tft_gc9a01.bytes_pushed;
+  const auto t0 = Clock::now();
+  for (int i = 0; i < reps; ++i) {
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(nullptr);
+  }
+  return {name, (unsigned)reps, ms_since(t0) / reps, (tft_gc9a01.bytes_pushed - b0) / reps};
+}
+
+// What the clock page costs every half second once it is up.
+Row bench_clock(int reps) {
+  ui::show(0);
+  run_for(600);
+  const uint64_t b0 = tft_gc9a01.bytes_pushed;
+  double ms = 0;
+  for (int i = 0; i < reps; ++i) {
+    sim::advance_us(490000);
+    const auto t0 = Clock::now();
+    for (int k = 0; k < 2; ++k) { sim::advance_us(5000); ui::pump(); }
+    ms += ms_since(t0);
+  }
+  return {"clock tick", (unsigned)reps, ms / reps, (tft_gc9a01.bytes_pushed - b0) / reps};
+}
+
+// A controller-paced (50 Hz) horizontal swipe, then the slide it starts. Wall time
+// covers everything the LVGL task does from the first sample to the settled page.
+Row bench_swipe(uint16_t from, bool left, uint16_t pages, bool& ok) {
+  ui::show(from);
+  run_for(300);
+  const uint16_t want = left ? (from + 1) % pages : (from + pages - 1) % pages;
+  const uint32_t f0 = transition::stats().frames;
+  const uint64_t b0 = tft_gc9a01.bytes_pushed;
+  const auto t0 = Clock::now();
+
+  uint16_t x = 0;
+  for (int i = 0; i <= 4; ++i) {
+    x = left ? 200 - 40 * i : 40 + 40 * i;
+    sim::touch({(uint32_t)sim::now_us(), x, 120, 0, true});
+    run_for(20, 1);
+  }
+  sim::touch({(uint32_t)sim::now_us(), x, 120, 0, false});
+  for (int ms = 0; ms < 1000 && (ms < 20 || transition::active()); ++ms) run_for(1, 1);
+  run_for(30, 1);   // the page LVGL redraws once the slide hands back
+
+  const double wall = ms_since(t0);
+  const unsigned frames = transition::stats().frames - f0;
+  if (ui::current_index() != want) {
+    std::printf("  swipe from page %u landed on %u, expected %u\n", from, ui::current_index(), want);
+    ok = false;
+  }
+  char name[32];
+  std::snprintf(name, sizeof(name), "swipe %u -> %u", from, want);
+  return {name, frames, frames ? wall / frames : wall, tft_gc9a01.bytes_pushed - b0};
+}
+
+// ---- Golden images (binary PPM, RGB888 expanded from the panel's RGB565) ----
+
+void rgb(uint16_t c, uint8_t* out) {
+  out[0] = (uint8_t)(((c >> 11) & 0x1f) * 255 / 31);
+  out[1] = (uint8_t)(((c >> 5) & 0x3f) * 255 / 63);
+  out[2] = (uint8_t)((c & 0x1f) * 255 / 31);
+}
+
+bool write_ppm(const std::string& path, const std::vector<uint8_t>& img) {
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  std::fprintf(f, "P6\n%d %d\n255\n", TFT_WIDTH, TFT_HEIGHT);
+  const bool ok = std::fwrite(img.data(), 1, img.size(), f) == img.size();
+  std::fclose(f);
+  return ok;
+}
+
+bool read_ppm(const std::string& path, std::vector<uint8_t>& img) {
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return false;
+  int w = 0, h = 0, max = 0;
+  const bool hdr = std::fscanf(f, "P6 %d %d %d", &w, &h, &max) == 3 && std::fgetc(f) != EOF;
+  img.resize((size_t)TFT_WIDTH * TFT_HEIGHT * 3);
+  const bool ok = hdr && w == TFT_WIDTH && h == TFT_HEIGHT && max == 255 &&
+                  std::fread(img.data(), 1, img.size(), f) == img.size();
+  std::fclose(f);
+  return ok;
+}
+
+std::vector<uint8_t> panel_image() {
+  std::vector<uint8_t> img((size_t)TFT_WIDTH * TFT_HEIGHT * 3);
+  for (size_t i = 0; i < (size_t)TFT_WIDTH * TFT_HEIGHT; ++i) rgb(tft_gc9a01.pixels[i], &img[i * 3]);
+  return img;
+}
+
+// Returns false on a mismatch or a missing golden.
+bool check_golden(uint16_t page, const Options& opt) {
+  const std::string name = "page_" + std::to_string(page) + ".ppm";
+  const std::vector<uint8_t> got = panel_image();
+  if (opt.update) {
+    mkdir(opt.golden.c_str(), 0755);
+    if (!write_ppm(opt.golden + "/" + name, got)) { std::printf("  can't write %s/%s\n", opt.golden.c_str(), name.c_str()); return false; }
+    return true;
+  }
+  std::vector<uint8_t> want;
+  if (!read_ppm(opt.golden + "/" + name, want)) {
+    mkdir(opt.out.c_str(), 0755);
+    write_ppm(opt.out + "/" + name, got);
+    std::printf("  no golden for page %u in %s/ (run with --update, then commit it)\n", page, opt.golden.c_str());
+    return false;
+  }
+  std::vector<uint8_t> diff(got.size(), 0);
+  unsigned bad = 0;
+  for (size_t i = 0; i < got.size(); i += 3) {
+    if (memcmp(&got[i], &want[i], 3) == 0) { diff[i] = diff[i + 1] = diff[i + 2] = got[i + 1] / 4; continue; }
+    bad++;
+    diff[i] = 255;
+  }
+  if (bad <= opt.tolerance) return true;
+  mkdir(opt.out.c_str(), 0755);
+  write_ppm(opt.out + "/" + name, got);
+  write_ppm(opt.out + "/diff_" + name, diff);
+  std::printf("  page %u differs from its golden in %u px (see %s/)\n", page, bad, opt.out.c_str());
+  return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const bool more = i + 1 < argc;
+    if (!strcmp(a, "--update")) opt.update = true;
+    else if (!strcmp(a, "--reps") && more) opt.reps = std::max(1, atoi(argv[++i]));
+    else if (!strcmp(a, "--tolerance") && more) opt.tolerance = (unsigned)atoi(argv[++i]);
+    else if (!strcmp(a, "--golden") && more) opt.golden = argv[++i];
+    else if (!strcmp(a, "--out") && more) opt.out = argv[++i];
+    else { std::fprintf(stderr, "unknown option %s\n", a); return 2; }
+  }
+
+  seed_profile();
+  lvgl_hal_init();
+  ui::begin();
+  power::Config pc;
+  pc.dim_after_s = pc.off_after_s = 0;   // long runs must not put the panel to sleep
+  power::configure(pc);
+  run_for(500);
+
+  bool ok = true;
+  const uint16_t pages = storage::count() + 1;
+
+  std::printf("pages (full-screen redraw)\n");
+  for (uint16_t p = 0; p < pages; ++p) {
+    ui::show(p);
+    run_for(300);
+    print_row(bench_redraw(p ? "macro page " + std::to_string(p) : std::string("clock page"), opt.reps));
+    ok &= check_golden(p, opt);
+  }
+
+  std::printf("updates\n");
+  print_row(bench_clock(opt.reps));
+
+  std::printf("swipes\n");
+  for (uint16_t p = 0; p < pages; ++p) print_row(bench_swipe(p, true, pages, ok));
+  for (uint16_t p = 0; p < pages; ++p) print_row(bench_swipe(p, false, pages, ok));
+
+  const transition::Stats ts = transition::stats();
+  std::printf("slides %u, frames %u, dropped %u\n", ts.runs, ts.frames, ts.dropped);
+  std::printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#pragma once
+// Host stand-in for the parts of the Arduino core the UI uses (sim build only).
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <string>
+#include <type_traits>
+#include <algorithm>
+
+#define IRAM_ATTR
+#define HIGH 1
+#define LOW  0
+#define OUTPUT 1
+#define INPUT  0
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+class String {
+  std::string s_;
+public:
+  String() {}
+  String(const char* c) : s_(c ? c : "") {}
+  String(const char* c, size_t n) : s_(c, n) {}
+  String(const std::string& s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+  explicit String(T v) : s_(std::to_string(v)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  void setCharAt(unsigned int i, char c) { if (i < s_.size()) s_[i] = c; }
+
+  bool concat(const char* c) { if (c) s_ += c; return true; }
+  bool concat(const char* c, unsigned int n) { if (c) s_.append(c, n); return true; }
+  bool concat(const String& o) { s_ += o.s_; return true; }
+  bool concat(char c) { s_ += c; return true; }
+  template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+  bool concat(T v) { s_ += std::to_string(v); return true; }
+
+  template <typename T> String& operator+=(const T& v) { concat(v); return *this; }
+
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* c) const { return s_ == (c ? c : ""); }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* c) const { return !(*this == c); }
+  bool operator<(const String& o) const { return s_ < o.s_; }
+  bool equals(const String& o) const { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String& o) const {
+    String a = *this, b = o; a.toLowerCase(); b.toLowerCase(); return a == b;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { auto p = s_.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+  int indexOf(const String& o, unsigned int from = 0) const { auto p = s_.find(o.s_, from); return p == std::string::npos ? -1 : (int)p; }
+  int lastIndexOf(char c) const { auto p = s_.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+  bool startsWith(const String& o) const { return s_.compare(0, o.s_.size(), o.s_) == 0; }
+  bool endsWith(const String& o) const { return s_.size() >= o.s_.size() && s_.compare(s_.size() - o.s_.size(), o.s_.size(), o.s_) == 0; }
+  String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s_.size()) return String();
+    return String(s_.substr(from, to - from));
+  }
+  void remove(unsigned int idx) { if (idx < s_.size()) s_.erase(idx); }
+  void remove(unsigned int idx, unsigned int n) { if (idx < s_.size()) s_.erase(idx, n); }
+  void replace(const String& from, const String& to) {
+    if (from.s_.empty()) return;
+    for (size_t p = 0; (p = s_.find(from.s_, p)) != std::string::npos; p += to.s_.size()) s_.replace(p, from.s_.size(), to.s_);
+  }
+  void toLowerCase() { for (auto& c : s_) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (auto& c : s_) c = (char)toupper((unsigned char)c); }
+  void trim() {
+    size_t a = s_.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) { s_.clear(); return; }
+    s_ = s_.substr(a, s_.find_last_not_of(" \t\r\n") - a + 1);
+  }
+  long toInt() const { return atol(s_.c_str()); }
+  float toFloat() const { return (float)atof(s_.c_str()); }
+};
+
+// The core's operator+ returns this so chains like String("a") + 1 + "b" work;
+// ArduinoJson also recognizes it as a string type.
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String& s) : String(s) {}
+};
+
+template <typename T>
+inline StringSumHelper operator+(const String& a, const T& b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const char* a, const String& b) { StringSumHelper r(a); r.concat(b); return r; }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) { size_t i = 0; while (i < n && write(buf[i])) ++i; return i; }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+  size_t print(T v) { return print(String(std::to_string(v))); }
+  template <typename T> size_t println(const T& v) { size_t n = print(v); return n + print('\n'); }
+  size_t println() { return print('\n'); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list ap; va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return n > 0 ? write((const uint8_t*)buf, std::min((size_t)n, sizeof(buf) - 1)) : 0;
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char* buf, size_t n) {
+    size_t i = 0;
+    for (int c; i < n && (c = read()) >= 0; ++i) buf[i] = (char)c;
+    return i;
+  }
+  size_t readBytes(uint8_t* buf, size_t n) { return readBytes((char*)buf, n); }
+  bool find(const char* target) { return findUntil(target, nullptr); }
+  // Consumes input up to and including `target`; false if `terminator` or the end came first.
+  bool findUntil(const char* target, const char* terminator) {
+    size_t ti = 0, ki = 0, tl = strlen(target), kl = terminator ? strlen(terminator) : 0;
+    for (int c; (c = read()) >= 0;) {
+      ti = (c == target[ti]) ? ti + 1 : (c == target[0] ? 1 : 0);
+      if (ti == tl) return true;
+      if (kl) {
+        ki = (c == terminator[ki]) ? ki + 1 : (c == terminator[0] ? 1 : 0);
+        if (ki == kl) return false;
+      }
+    }
+    return false;
+  }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+struct EspClass {
+  [[noreturn]] void restart() { fflush(stdout); exit(0); }
+  uint32_t getFreeHeap() { return 0; }
+};
+extern EspClass ESP;
+
+#include "esp32-hal-psram.h"
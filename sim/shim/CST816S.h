@@ -0,0 +1,11 @@
+#pragma once
+// Sim build: no touch controller; samples are injected through lvgl_hal_on_touch.
+#include <stdint.h>
+
+struct touch_event_t {
+  uint16_t x, y;
+  uint8_t gesture;
+  bool finger;
+};
+
+class CST816S {};
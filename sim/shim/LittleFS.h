@@ -0,0 +1,88 @@
+#pragma once
+// Sim build: LittleFS held in memory. Files live in a path -> bytes map for the
+// life of the process; directories are implicit.
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+  std::shared_ptr<std::vector<uint8_t>> data_;
+  size_t pos_ = 0;
+  bool write_ = false;
+public:
+  File() {}
+  File(std::shared_ptr<std::vector<uint8_t>> d, bool wr, bool append)
+    : data_(std::move(d)), pos_(append ? data_->size() : 0), write_(wr) {}
+
+  explicit operator bool() const { return (bool)data_; }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    if (!data_ || !write_) return 0;
+    if (pos_ + n > data_->size()) data_->resize(pos_ + n);
+    memcpy(data_->data() + pos_, buf, n);
+    pos_ += n;
+    return n;
+  }
+  using Print::write;
+  int available() override { return data_ ? (int)(data_->size() - pos_) : 0; }
+  int read() override { return available() > 0 ? (*data_)[pos_++] : -1; }
+  int peek() override { return available() > 0 ? (*data_)[pos_] : -1; }
+  size_t read(uint8_t* buf, size_t n) {
+    n = std::min(n, (size_t)available());
+    if (n) memcpy(buf, data_->data() + pos_, n);
+    pos_ += n;
+    return n;
+  }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+    if (!data_) return false;
+    size_t base = mode == SeekSet ? 0 : mode == SeekCur ? pos_ : data_->size();
+    if (base + pos > data_->size()) return false;
+    pos_ = base + pos;
+    return true;
+  }
+  size_t position() const { return pos_; }
+  size_t size() const { return data_ ? data_->size() : 0; }
+  void flush() {}
+  void close() { data_.reset(); }
+};
+
+class FS {
+  std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files_;
+public:
+  bool begin(bool = false) { return true; }
+  void end() {}
+  bool exists(const char* path) const { return files_.count(path) != 0; }
+  bool exists(const String& path) const { return exists(path.c_str()); }
+  File open(const char* path, const char* mode = "r") {
+    const bool wr = mode[0] == 'w' || mode[0] == 'a';
+    auto it = files_.find(path);
+    if (it == files_.end()) {
+      if (!wr) return File();
+      it = files_.emplace(path, std::make_shared<std::vector<uint8_t>>()).first;
+    } else if (mode[0] == 'w') {
+      it->second = std::make_shared<std::vector<uint8_t>>();   // open handles keep the old contents
+    }
+    return File(it->second, wr, mode[0] == 'a');
+  }
+  File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+  bool mkdir(const char*) { return true; }
+  bool mkdir(const String&) { return true; }
+  bool remove(const char* path) { return files_.erase(path) != 0; }
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to) {
+    auto it = files_.find(from);
+    if (it == files_.end()) return false;
+    auto d = it->second;
+    files_.erase(it);
+    files_[to] = d;
+    return true;
+  }
+  size_t totalBytes() const { return 1024 * 1024; }
+  size_t usedBytes() const { size_t n = 0; for (auto& f : files_) n += f.second->size(); return n; }
+};
+
+extern FS LittleFS;
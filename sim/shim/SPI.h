@@ -0,0 +1,2 @@
+#pragma once
+// Sim build: nothing is on a bus.
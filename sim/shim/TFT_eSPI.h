@@ -0,0 +1,46 @@
+#pragma once
+// Sim build: the GC9A01 becomes a 240x240 RGB565 memory panel that counts
+// what would have gone over SPI.
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH  240
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 240
+#endif
+#define TFT_BLACK 0x0000
+
+class TFT_eSPI {
+public:
+  uint16_t pixels[TFT_WIDTH * TFT_HEIGHT] = {};   // native RGB565, not byte swapped
+  uint64_t bytes_pushed = 0;
+  uint32_t windows = 0;
+
+  void begin() {}
+  void init() {}
+  void invertDisplay(bool) {}
+  void setRotation(uint8_t) {}
+  void fillScreen(uint16_t c) { for (auto& p : pixels) p = c; }
+  uint8_t last_command = 0;
+  void writecommand(uint8_t c) { last_command = c; }
+  void writedata(uint8_t) {}
+  void startWrite() {}
+  void endWrite() {}
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    wx_ = x; wy_ = y; ww_ = w; wh_ = h; wi_ = 0; windows++;
+  }
+  void pushColors(uint16_t* data, uint32_t len, bool swap = true) {
+    (void)swap;   // only changes byte order on the wire; keep pixels as LVGL drew them
+    bytes_pushed += (uint64_t)len * 2;
+    for (uint32_t i = 0; i < len && wi_ < (uint32_t)(ww_ * wh_); ++i, ++wi_) {
+      const int32_t x = wx_ + (int32_t)(wi_ % ww_), y = wy_ + (int32_t)(wi_ / ww_);
+      if (x >= 0 && y >= 0 && x < TFT_WIDTH && y < TFT_HEIGHT) pixels[y * TFT_WIDTH + x] = data[i];
+    }
+  }
+
+private:
+  int32_t wx_ = 0, wy_ = 0, ww_ = 0, wh_ = 0;
+  uint32_t wi_ = 0;
+};
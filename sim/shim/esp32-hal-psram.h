@@ -0,0 +1,10 @@
+#pragma once
+// Sim build: PSRAM is ordinary heap. Included from C too (lv_conf.h).
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+static inline void* ps_malloc(size_t n) { return malloc(n); }
+static inline void* ps_calloc(size_t n, size_t size) { return calloc(n, size); }
+static inline void* ps_realloc(void* p, size_t n) { return realloc(p, n); }
+static inline bool psramFound(void) { return true; }
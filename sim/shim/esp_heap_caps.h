@@ -0,0 +1,20 @@
+#pragma once
+// Sim build: every capability is ordinary heap; sizes are what glibc reports.
+#include <stdlib.h>
+#include <stddef.h>
+#include <malloc.h>
+
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+
+static inline void* heap_caps_malloc(size_t n, unsigned) { return malloc(n); }
+static inline void* heap_caps_calloc(size_t n, size_t size, unsigned) { return calloc(n, size); }
+static inline void heap_caps_free(void* p) { free(p); }
+static inline size_t heap_caps_get_total_size(unsigned) { return 8u * 1024 * 1024; }
+static inline size_t heap_caps_get_free_size(unsigned) {
+  struct mallinfo2 mi = mallinfo2();
+  const size_t total = 8u * 1024 * 1024;
+  return mi.uordblks < total ? total - mi.uordblks : 0;
+}
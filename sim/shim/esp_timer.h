@@ -0,0 +1,12 @@
+#pragma once
+// Sim build: esp_timer_get_time() reads the simulator's virtual clock (sim/main.cpp),
+// so animations and stats advance with simulated time, not with how fast the host renders.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int64_t esp_timer_get_time(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+#include "touch_sample.hpp"
+
+// Host simulator plumbing shared by sim/*.cpp.
+namespace sim {
+
+int64_t now_us();                       // virtual clock behind esp_timer_get_time() and millis()
+void advance_us(int64_t us);            // move it forward (LV_TICK_CUSTOM reads the same clock)
+void touch(const touch::Sample& s);     // queue a sample the way the touch task would
+
+} // namespace sim
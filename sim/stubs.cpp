@@ -0,0 +1,80 @@
+// Firmware modules the UI calls but the simulator has no hardware for.
+#include "touch.hpp"
+#include "macros.hpp"
+#include "rtc_time.hpp"
+#include "lvgl_hal.h"
+#include "backlight.hpp"
+#include "boot.hpp"
+#include "coex.hpp"
+#include "sim.hpp"
+#include <deque>
+#include <time.h>
+
+namespace {
+std::deque<touch::Sample> g_samples;
+touch::Stats g_touchStats{};
+uint8_t g_backlight = 0;
+// Fixed wall clock so the clock page renders the same every run (golden images).
+constexpr time_t kEpoch = 1760875200;   // Sun, 19 Oct 2025 12:00 UTC
+}
+
+void sim::touch(const touch::Sample& s){
+  g_samples.push_back(s);
+  g_touchStats.samples++;
+  lvgl_hal_touch_kick();
+}
+
+namespace touch {
+bool begin(CST816S&){ return true; }
+bool read(Sample& out){
+  if(g_samples.empty()) return false;
+  out = g_samples.front();
+  g_samples.pop_front();
+  return true;
+}
+bool pending(){ return !g_samples.empty(); }
+void wake_on_sample(TaskHandle_t){}
+Stats stats(){ return g_touchStats; }
+bool record_start(){ return false; }
+int record_stop(const char*){ return -1; }
+bool recording(){ return false; }
+} // namespace touch
+
+namespace boot {
+void tap(){}
+} // namespace boot
+
+void coex::wake(){ Serial.println("[SIM] Wi-Fi wake requested"); }
+
+// No RMT on the host: fades land on their target at once.
+namespace backlight {
+bool begin(){ return true; }
+void set(uint8_t level){ g_backlight = level > kLevels ? kLevels : level; }
+void fade_to(uint8_t level, uint32_t){ set(level); }
+void cancel(){}
+uint8_t level(){ return g_backlight; }
+bool fading(){ return false; }
+} // namespace backlight
+
+namespace macros {
+void enqueue(Type type, const String& payload){
+  Serial.printf("[SIM] macro %s \"%s\"\n", type_to_string(type), payload.c_str());
+}
+bool can_hold(Type type, const String&){ return type == Type::Keybind; }
+void enqueue_hold(const String& payload, bool down){
+  Serial.printf("[SIM] hold %s %s\n", payload.c_str(), down ? "down" : "up");
+}
+} // namespace macros
+
+void rtime::begin(){}
+void rtime::loop(){}
+bool rtime::valid(){ return true; }
+void rtime::set_from_epoch_ms(uint64_t, int){}
+time_t rtime::local_now(){ return kEpoch; }
+void rtime::format(char* out, size_t n, const char* timeFmt, const char* dateFmt){
+  struct tm tm; gmtime_r(&kEpoch, &tm);
+  char tbuf[32], dbuf[48];
+  strftime(tbuf, sizeof(tbuf), timeFmt, &tm);
+  strftime(dbuf, sizeof(dbuf), dateFmt, &tm);
+  snprintf(out, n, "%s\n%s", tbuf, dbuf);
+}
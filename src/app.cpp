@@ -6,9 +6,6 @@
 extern "C" {
   #include "esp_system.h"
   #include "esp_wifi.h"
-  #if __has_include("esp_coexist.h")
-  #include "esp_coexist.h"
-  #endif
 }
 #include "storage.hpp"
 #include "ui.hpp"
@@ -17,6 +14,9 @@ extern "C" {
 #include "ble_hid.hpp"
 #include "macros.hpp"
 #include "rtc_time.hpp"
+#include "cpu_load.hpp"
+#include "boot.hpp"
+#include "coex.hpp"
 
 static uint32_t t_ble = 0;
 static uint32_t _hb_last = 0;
@@ -26,39 +26,64 @@ static void onStaTry()  { /* optional */ }
 static void onStaOK()   { ui::wifi_ok(); }
 static void onStaFail() { ui::wifi_failed(); }
 
-void app_begin() {
-  Serial.begin(115200);
-  delay(50);
-  Serial.printf("[BOOT] reset_reason=%d\n", (int)esp_reset_reason());
+using boot::Phase;
+using boot::bit;
+
+static constexpr uint32_t kWifiDelayMs = 3000;   // Background: after the macropad is usable
+
+static bool wifi_up() {
   // REQUIRED by ESP-IDF when Wi-Fi + BLE coexist: enable modem sleep
   WiFi.persistent(false);
   WiFi.setSleep(true);
   esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
   Serial.println("[BOOT] WiFi modem sleep ENABLED (MIN_MODEM) for BLE coexist");
+  // from here on coex:: adjusts the sleep level to web and macro activity
 
-#if defined(ESP_COEX_PREFER_BT) || defined(CONFIG_BT_COEXIST)
-  esp_coex_preference_set(ESP_COEX_PREFER_BT);
-  Serial.println("[BOOT] Coexistence preference: BT");
-#endif
+  net::WifiCallbacks cb{ onAp, onStaTry, onStaOK, onStaFail };
+  return net::begin("Basilisk KnomiPad", "", 15000, cb);
+}
 
-  Serial.printf("[BOOT] LV_USE_PNG=%d LV_USE_SVG=%d\n",(int)LV_USE_PNG,(int)LV_USE_SVG);
-  LittleFS.begin(true);
-  storage::load();
-  macros::begin_async();
+// Core 0: BLE comes up while core 1 loads the profile and builds the UI. Wi-Fi and
+// everything behind it wait until the macropad is usable, then start in the
+// background or, with Start::OnDemand, only when asked for.
+static void radio_boot(void*) {
+  boot::run(Phase::Ble, []{ return knomi::ble_begin_keyboard("KnomiPad"); });
+  boot::wait(bit(Phase::Ui));
+  const net::Start policy = net::config().start;
+  Serial.printf("[BOOT] Wi-Fi start: %s\n", net::start_name(policy));
+  net::wait_for_start(policy == net::Start::OnDemand ? UINT32_MAX : kWifiDelayMs);
+  boot::run(Phase::Wifi, wifi_up, bit(Phase::Fs));
+  boot::run(Phase::Time, []{ rtime::begin(); return true; }, bit(Phase::Wifi));   // SNTP needs the IP stack
+  // handlers read the profile and post to the UI
+  boot::run(Phase::Web, web::begin, bit(Phase::Wifi) | bit(Phase::Profile) | bit(Phase::Ui));
+  vTaskDelete(nullptr);
+}
+
+void app_begin() {
+  Serial.begin(115200);
+  delay(50);
+  Serial.printf("[BOOT] reset_reason=%d\n", (int)esp_reset_reason());
+  boot::begin();
+  cpu_load::begin();
 
-  knomi::ble_begin_keyboard("KnomiPad");
+  Serial.printf("[BOOT] LV_USE_PNG=%d LV_USE_SVG=%d\n",(int)LV_USE_PNG,(int)LV_USE_SVG);
+  // The only mount; the splash may have mounted it already (then this is a no-op)
+  boot::run(Phase::Fs, []{ return LittleFS.begin(true); });
+  xTaskCreatePinnedToCore(radio_boot, "boot_radio", 8192, nullptr, 2, nullptr, 0);
 
-  net::WifiCallbacks cb{ onAp, onStaTry, onStaOK, onStaFail };
-  net::begin("Basilisk KnomiPad", "", 15000, cb);
+  boot::run(Phase::Macros, []{ macros::begin_async(); return true; });
+  boot::run(Phase::Profile, []{ storage::load(); return true; }, bit(Phase::Fs));   // defaults if there is none
+  boot::run(Phase::Ui, []{ ui::begin(); return true; }, bit(Phase::Profile));   // lvgl screens
 
-  web::begin();    // http api/ui
-  rtime::begin();
-  ui::begin();     // lvgl screens
+  // Wi-Fi may start much later or never; app_loop only polls what is up
+  boot::wait(bit(Phase::Ble));
+  Serial.printf("[BOOT] usable at %u ms\n", (unsigned)boot::usable_ms());
 }
 
 void app_loop() {
-  net::loop();
-  web::loop();
+  if (boot::done(Phase::Wifi)) net::loop();
+  if (boot::done(Phase::Web)) web::loop();
+  coex::loop();
   rtime::loop();
   // BLE pill refresh every 500ms
   if (millis() - t_ble > 500) {
@@ -67,10 +92,11 @@ void app_loop() {
   }
   if (millis() - _hb_last > 1000) {
     _hb_last = millis();
-    Serial.printf("[HB] up=%lu ms, BLE=%d, STA_OK=%d, IP=%s\n",
+    Serial.printf("[HB] up=%lu ms, BLE=%d, STA_OK=%d, IP=%s, idle=%u/%u%%\n",
                   (unsigned long)millis(),
                   (int)knomi::ble_is_connected(),
                   (int)net::sta_ok(),
-                  WiFi.localIP().toString().c_str());
+                  WiFi.localIP().toString().c_str(),
+                  (unsigned)cpu_load::idle_pct(0), (unsigned)cpu_load::idle_pct(1));
   }
 }
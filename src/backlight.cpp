@@ -0,0 +1,144 @@
+#include "backlight.hpp"
+#include "pinout.h"
+#include <Arduino.h>
+extern "C" {
+  #include "driver/rmt.h"
+  #include "esp_timer.h"
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/semphr.h"
+}
+
+namespace {
+
+constexpr rmt_channel_t kChannel   = RMT_CHANNEL_0;
+constexpr uint8_t  kClkDiv         = 80;     // 1 us ticks
+constexpr uint16_t kPulseUs        = 2;      // low and high time per step: 0.5 us < T < 500 us
+constexpr uint16_t kPowerOnUs      = 30;     // high before the first step, > 20 us
+constexpr int64_t  kShutdownUs     = 3000;   // low this long switches the chip off, > 2.5 ms
+constexpr uint32_t kLeadUs         = 500;    // least low time sent ahead of a power-on (chip already off)
+
+SemaphoreHandle_t g_mtx = nullptr;    // level changes: callers and the fade timer
+esp_timer_handle_t g_timer = nullptr;
+rmt_item32_t g_items[2 + 2 * backlight::kLevels];   // worst case: off wait, power-on, 15 steps
+bool     g_ready = false;
+uint8_t  g_level = 0;
+uint8_t  g_target = 0;
+bool     g_fading = false;
+int64_t  g_offSince = 0;
+
+struct Lock {
+  Lock()  { xSemaphoreTake(g_mtx, portMAX_DELAY); }
+  ~Lock() { xSemaphoreGive(g_mtx); }
+};
+
+rmt_item32_t item(uint32_t level0, uint32_t us0, uint32_t level1, uint32_t us1){
+  rmt_item32_t it;
+  it.level0 = level0; it.duration0 = us0;
+  it.level1 = level1; it.duration1 = us1;
+  return it;
+}
+
+// Move the chip to `to` (lock held). Returns after queueing the pulses, not after sending them;
+// the RMT driver holds the next write until this one is out.
+void apply(uint8_t to){
+  if(to == g_level || !g_ready) return;
+  if(to == 0){
+    rmt_set_idle_level(kChannel, true, RMT_IDLE_LEVEL_LOW);   // after any pulses still going out
+    g_level = 0;
+    g_offSince = esp_timer_get_time();
+    return;
+  }
+  size_t n = 0;
+  uint8_t from = g_level;
+  if(from == 0){
+    // Finish the shutdown low, or at least kLeadUs of it, so the idle switch below lands
+    // while the items still hold the line low.
+    const int64_t off = esp_timer_get_time() - g_offSince;
+    uint32_t lowUs = off < kShutdownUs ? (uint32_t)(kShutdownUs - off) : 0;
+    if(lowUs < kLeadUs) lowUs = kLeadUs;
+    g_items[n++] = item(0, lowUs / 2 + 1, 0, lowUs / 2 + 1);
+    g_items[n++] = item(1, kPowerOnUs / 2, 1, kPowerOnUs / 2);
+    from = backlight::kLevels;   // powers up at full brightness
+  }
+  int steps = (int)from - to;
+  if(steps < 0) steps += backlight::kLevels;
+  for(int i = 0; i < steps; ++i) g_items[n++] = item(0, kPulseUs, 1, kPulseUs);
+  rmt_write_items(kChannel, g_items, n, false);
+  // Idle high only once the channel is sending: on an idle channel it would raise the line
+  // at once and split the shutdown low with a pulse the chip counts as a step.
+  if(g_level == 0) rmt_set_idle_level(kChannel, true, RMT_IDLE_LEVEL_HIGH);
+  g_level = to;
+}
+
+void stop_fade(){
+  if(g_fading) esp_timer_stop(g_timer);
+  g_fading = false;
+}
+
+void on_step(void*){
+  Lock lk;
+  if(!g_fading) return;
+  apply(g_level < g_target ? g_level + 1 : g_level - 1);
+  if(g_level == g_target) stop_fade();
+}
+
+} // anon
+
+namespace backlight {
+
+bool begin(){
+  if(g_ready) return true;
+  if(!g_mtx) g_mtx = xSemaphoreCreateMutex();
+
+  rmt_config_t cfg = RMT_DEFAULT_CONFIG_TX((gpio_num_t)LCD_BL_PIN, kChannel);
+  cfg.clk_div = kClkDiv;
+  cfg.tx_config.idle_output_en = true;
+  cfg.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+  if(rmt_config(&cfg) != ESP_OK || rmt_driver_install(kChannel, 0, 0) != ESP_OK) return false;
+
+  const esp_timer_create_args_t args = {
+    .callback = on_step,
+    .arg = nullptr,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name = "backlight"
+  };
+  if(esp_timer_create(&args, &g_timer) != ESP_OK) return false;
+
+  g_level = g_target = 0;
+  g_offSince = esp_timer_get_time();
+  g_ready = true;
+  return true;
+}
+
+void set(uint8_t to){
+  if(!g_ready) return;
+  Lock lk;
+  stop_fade();
+  g_target = to > kLevels ? kLevels : to;
+  apply(g_target);
+}
+
+void fade_to(uint8_t to, uint32_t ms){
+  if(!g_ready) return;
+  Lock lk;
+  stop_fade();
+  g_target = to > kLevels ? kLevels : to;
+  const uint32_t steps = g_level > g_target ? g_level - g_target : g_target - g_level;
+  if(!steps) return;
+  if(steps == 1 || ms < steps){ apply(g_target); return; }
+  g_fading = true;
+  apply(g_level < g_target ? g_level + 1 : g_level - 1);   // first step right away
+  esp_timer_start_periodic(g_timer, (uint64_t)ms * 1000 / steps);
+}
+
+void cancel(){
+  if(!g_ready) return;
+  Lock lk;
+  stop_fade();
+  g_target = g_level;
+}
+
+uint8_t level(){ return g_level; }
+bool fading(){ return g_fading; }
+
+} // namespace backlight
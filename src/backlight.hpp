@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+
+// AW9346 backlight driver. The chip's one-wire dimming protocol (each low
+// pulse steps the brightness down one of 16 levels, wrapping at the bottom)
+// is clocked out by an RMT channel, so no caller ever busy-waits on it. Fades
+// step one level at a time from an esp_timer; starting a new fade or setting
+// a level cancels the running one. Safe to call from any task.
+namespace backlight {
+
+constexpr uint8_t kLevels = 16;   // 0 is off, 16 is full
+
+bool begin();                               // RMT on LCD_BL_PIN, backlight off
+void set(uint8_t level);                    // jump there now
+void fade_to(uint8_t level, uint32_t ms);   // reach `level` after about `ms`, evenly stepped
+void cancel();                              // stop a fade where it is
+uint8_t level();                            // level the chip is at (mid-fade: the current step)
+bool fading();
+
+} // namespace backlight
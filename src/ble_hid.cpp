@@ -2,6 +2,10 @@
 #include <NimBLEDevice.h>
 #include <NimBLEHIDDevice.h>
 #include <NimBLEServer.h>
+#include "coex.hpp"
+extern "C" {
+  #include "esp_timer.h"
+}
 
 static int gapHandler(struct ble_gap_event *event, void *arg);
 
@@ -23,7 +27,9 @@ static inline void send_report_raw(uint8_t mods, uint8_t key) {
   if (!can_notify()) return;
   uint8_t r[8] = {mods, 0, key, 0, 0, 0, 0, 0};
   g_input->setValue(r, sizeof(r));
+  const int64_t t0 = esp_timer_get_time();
   g_input->notify();
+  coex::record_notify((uint32_t)(esp_timer_get_time() - t0));
 }
 
 const uint8_t REPORT_ID = 1;
@@ -118,7 +124,9 @@ static void send_report(uint8_t mods, uint8_t k0) {
   if (!can_notify()) { Serial.println("[BLE] skip notify (not subscribed)"); return; }
   uint8_t report[8] = {mods,0x00,k0,0x00,0x00,0x00,0x00,0x00};
   g_input->setValue(report, sizeof(report));
+  const int64_t t0 = esp_timer_get_time();
   g_input->notify();
+  coex::record_notify((uint32_t)(esp_timer_get_time() - t0));
   delay(6);
 }
 
@@ -0,0 +1,74 @@
+#include "boot.hpp"
+#include <Arduino.h>
+extern "C" {
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/event_groups.h"
+  #include "esp_timer.h"
+}
+
+namespace {
+
+constexpr size_t kPhases = (size_t)boot::Phase::Count;
+
+EventGroupHandle_t g_done = nullptr;
+boot::Record g_rec[kPhases];
+volatile uint32_t g_firstTap = 0;
+
+uint32_t now_ms(){ return (uint32_t)(esp_timer_get_time() / 1000); }
+
+} // anon
+
+namespace boot {
+
+void begin(){
+  if(g_done) return;
+  g_done = xEventGroupCreate();
+  for(auto& r : g_rec) r = Record{0, 0, -1, false};
+}
+
+bool run(Phase p, bool (*fn)(), uint32_t needs){
+  if(needs) xEventGroupWaitBits(g_done, needs, pdFALSE, pdTRUE, portMAX_DELAY);
+  Record& r = g_rec[(size_t)p];
+  r.start_ms = now_ms();
+  r.core = (int8_t)xPortGetCoreID();
+  r.ok = fn();
+  r.end_ms = now_ms();
+  Serial.printf("[BOOT] %s %s in %u ms (core %d)\n", name(p), r.ok ? "up" : "FAILED",
+                (unsigned)(r.end_ms - r.start_ms), (int)r.core);
+  xEventGroupSetBits(g_done, bit(p));
+  return r.ok;
+}
+
+void wait(uint32_t phases){ xEventGroupWaitBits(g_done, phases, pdFALSE, pdTRUE, portMAX_DELAY); }
+
+bool done(Phase p){ return g_done && (xEventGroupGetBits(g_done) & bit(p)); }
+
+void tap(){ if(!g_firstTap) g_firstTap = now_ms(); }
+
+Record record(Phase p){ return g_rec[(size_t)p]; }
+
+const char* name(Phase p){
+  switch(p){
+    case Phase::Fs:      return "fs";
+    case Phase::Macros:  return "macros";
+    case Phase::Profile: return "profile";
+    case Phase::Ui:      return "ui";
+    case Phase::Ble:     return "ble";
+    case Phase::Wifi:    return "wifi";
+    case Phase::Time:    return "time";
+    case Phase::Web:     return "web";
+    default:             return "?";
+  }
+}
+
+uint32_t usable_ms(){
+  if(!g_done) return 0;
+  const uint32_t need = bit(Phase::Ui) | bit(Phase::Ble);
+  if((xEventGroupGetBits(g_done) & need) != need) return 0;
+  const uint32_t ui = g_rec[(size_t)Phase::Ui].end_ms, ble = g_rec[(size_t)Phase::Ble].end_ms;
+  return ui > ble ? ui : ble;
+}
+
+uint32_t first_tap_ms(){ return g_firstTap; }
+
+} // namespace boot
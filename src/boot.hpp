@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+// Boot sequencer. Each phase names the phases it needs; run() blocks until
+// those are done, so independent work can be started from different tasks
+// (radios on core 0, profile and UI on core 1) and still come up in a valid
+// order. Every phase is timed for /api/boot. A failed phase still counts as
+// done: what depends on it runs and copes, boot never stalls.
+namespace boot {
+
+enum class Phase : uint8_t { Fs, Macros, Profile, Ui, Ble, Wifi, Time, Web, Count };
+constexpr uint32_t bit(Phase p){ return 1u << (uint8_t)p; }
+constexpr uint32_t kAll = (1u << (uint8_t)Phase::Count) - 1;
+
+struct Record {
+  uint32_t start_ms, end_ms;   // esp_timer clock: since the chip came out of reset
+  int8_t   core;               // -1: not run yet
+  bool     ok;
+};
+
+void begin();                                            // first thing in app_begin
+bool run(Phase p, bool (*fn)(), uint32_t needs = 0);     // wait for `needs`, run and time fn here
+void wait(uint32_t phases);
+bool done(Phase p);
+void tap();                                              // a tap reached a page (LVGL task)
+
+Record record(Phase p);
+const char* name(Phase p);
+uint32_t usable_ms();      // UI and BLE both up: the first tap can do something; 0 until then
+uint32_t first_tap_ms();   // 0 until the first tap
+
+} // namespace boot
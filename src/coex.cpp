@@ -0,0 +1,136 @@
+#include "coex.hpp"
+#include "net.hpp"
+#include "ble_hid.hpp"
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include <mutex>
+extern "C" {
+  #include "esp_wifi.h"
+}
+
+namespace {
+
+constexpr uint32_t kCheckMs = 250;
+constexpr size_t   kStates  = (size_t)coex::State::Count;
+
+struct Acc {                      // Welford running mean/variance
+  uint32_t n = 0;
+  float    mean = 0, m2 = 0;
+  uint32_t max = 0;
+};
+
+std::mutex g_mtx;                 // radio settings and notify costs: loop, macro and web tasks
+coex::Config g_cfg;
+std::atomic<coex::State> g_state{coex::State::Off};
+std::atomic<bool> g_wakeReq{false};
+std::atomic<int>  g_macros{0};
+uint32_t g_lastWeb = 0;           // millis
+uint32_t g_bleSeen = 0;
+uint32_t g_lastCheck = 0;
+uint32_t g_transitions = 0;
+int      g_ps = -1;               // wifi_ps_type_t last applied
+Acc      g_acc[kStates];
+
+// Modem sleep level for the current state and macro activity.
+void apply(){
+  std::lock_guard<std::mutex> lk(g_mtx);
+  const coex::State s = g_state;
+  if(s == coex::State::Off || s == coex::State::Down) return;
+  const bool macro = g_macros > 0;
+  const wifi_ps_type_t ps = (macro || s == coex::State::Idle) ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM;
+  if(ps != g_ps){ esp_wifi_set_ps(ps); g_ps = ps; }
+}
+
+void enter(coex::State s){
+  if(s == g_state) return;
+  Serial.printf("[COEX] %s -> %s\n", coex::state_name(g_state), coex::state_name(s));
+  const coex::State from = g_state;
+  g_state = s;
+  g_transitions++;
+  if(s == coex::State::Down) net::suspend();
+  else if(from == coex::State::Down) net::resume();
+  if(s == coex::State::Down || from == coex::State::Down) g_ps = -1;   // driver restarts with its defaults
+  apply();
+}
+
+} // anon
+
+namespace coex {
+
+void loop(){
+  const uint32_t now = millis();
+  if(now - g_lastCheck < kCheckMs) return;
+  g_lastCheck = now;
+  if(!net::started()) return;
+
+  const bool ble = knomi::ble_is_connected();
+  if(ble) g_bleSeen = now;
+  if(g_state == State::Off){ g_lastWeb = g_bleSeen = now; enter(State::Active); }
+  if(g_wakeReq.exchange(false)){ g_lastWeb = now; enter(State::Active); return; }
+
+  const uint32_t idle = now - g_lastWeb;
+  switch(g_state.load()){
+    case State::Active:
+      if(idle >= g_cfg.idle_after_s * 1000u) enter(State::Idle);
+      break;
+    case State::Idle:
+      if(idle < g_cfg.idle_after_s * 1000u) enter(State::Active);
+      else if(g_cfg.down_after_s && ble && idle >= g_cfg.down_after_s * 1000u) enter(State::Down);
+      break;
+    case State::Down:
+      // nothing to share airtime with: let the web editor be reachable again
+      if(!ble && now - g_bleSeen >= g_cfg.ble_idle_s * 1000u){ g_lastWeb = now; enter(State::Active); }
+      break;
+    default: break;
+  }
+}
+
+void web_activity(){ g_lastWeb = millis(); }
+
+void wake(){
+  if(!net::started()){ net::request_start(); return; }
+  g_wakeReq = true;
+}
+
+void macro_begin(){ if(g_macros++ == 0) apply(); }
+void macro_end(){ if(--g_macros == 0) apply(); }
+
+void record_notify(uint32_t us){
+  std::lock_guard<std::mutex> lk(g_mtx);
+  Acc& a = g_acc[(size_t)g_state.load()];
+  a.n++;
+  const float d = (float)us - a.mean;
+  a.mean += d / a.n;
+  a.m2 += d * ((float)us - a.mean);
+  if(us > a.max) a.max = us;
+}
+
+State state(){ return g_state; }
+
+const char* state_name(State s){
+  switch(s){
+    case State::Active: return "active";
+    case State::Idle:   return "idle";
+    case State::Down:   return "down";
+    default:            return "off";
+  }
+}
+
+Config config(){ return g_cfg; }
+void configure(const Config& c){ g_cfg = c; }
+
+NotifyCost notify_cost(State s){
+  std::lock_guard<std::mutex> lk(g_mtx);
+  const Acc& a = g_acc[(size_t)s];
+  NotifyCost j{};
+  j.count = a.n;
+  j.mean_us = (uint32_t)a.mean;
+  j.stddev_us = a.n > 1 ? (uint32_t)sqrtf(a.m2 / (a.n - 1)) : 0;
+  j.max_us = a.max;
+  return j;
+}
+
+uint32_t transitions(){ return g_transitions; }
+
+} // namespace coex
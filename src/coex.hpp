@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// Wi-Fi/BLE airtime manager. Wi-Fi is only kept fully up while the web editor
+// is in use: after a quiet spell it drops to max modem sleep, later (with a BLE
+// host connected) the radio is stopped outright. A long press on the clock or a
+// BLE host going away brings it back. While a macro is being sent Wi-Fi sleeps
+// as much as it can. Only the modem-sleep level changes: the coexistence
+// arbiter's own BT/Wi-Fi priority is left at the IDF default. How long HID notify() takes to
+// hand a report to the NimBLE host is kept per state at /api/coex. That covers
+// host-side contention only, not airtime: NimBLE doesn't surface the
+// controller's completed-packets event, so radio latency isn't measured.
+namespace coex {
+
+enum class State : uint8_t {
+  Off,      // Wi-Fi not started (yet)
+  Active,   // web in use: min modem sleep
+  Idle,     // quiet: max modem sleep
+  Down,     // radio stopped
+  Count
+};
+
+struct Config {
+  uint16_t idle_after_s = 60;    // since the last HTTP request
+  uint16_t down_after_s = 600;   // 0: never stop the radio
+  uint16_t ble_idle_s   = 30;    // Down and no BLE host this long: bring Wi-Fi back
+};
+
+struct NotifyCost {              // BLE HID notify() calls made in one state
+  uint32_t count;
+  uint32_t mean_us;
+  uint32_t stddev_us;
+  uint32_t max_us;
+};
+
+void loop();                     // Arduino loop task; applies transitions
+void web_activity();             // an HTTP request arrived (web task)
+void wake();                     // any task: user wants Wi-Fi (starts it if it never was)
+void macro_begin();              // macro task, around each macro
+void macro_end();
+void record_notify(uint32_t us); // notify() returned after `us`: report queued in the host, not yet sent
+
+State state();
+const char* state_name(State s);
+Config config();
+void configure(const Config& c);
+NotifyCost notify_cost(State s);
+uint32_t transitions();
+
+} // namespace coex
@@ -0,0 +1,50 @@
+#include "cpu_load.hpp"
+#include <atomic>
+extern "C" {
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+  #include "esp_freertos_hooks.h"
+  #include "esp_attr.h"
+}
+
+namespace {
+
+struct Core {
+  uint16_t ticks;
+  uint16_t idle;
+  std::atomic<uint8_t> pct{255};
+};
+Core g_cores[portNUM_PROCESSORS];
+bool g_started = false;
+
+// Runs in the tick interrupt of core N, so the current task is the one it interrupted.
+template <int N>
+void IRAM_ATTR on_tick(){
+  Core& c = g_cores[N];
+  if(xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandleForCPU(N)) c.idle++;
+  if(++c.ticks < configTICK_RATE_HZ) return;
+  c.pct.store((uint8_t)(c.idle * 100u / c.ticks), std::memory_order_relaxed);
+  c.ticks = c.idle = 0;
+}
+
+} // anon
+
+namespace cpu_load {
+
+bool begin(){
+  if(g_started) return true;
+  bool ok = esp_register_freertos_tick_hook_for_cpu(on_tick<0>, 0) == ESP_OK;
+#if portNUM_PROCESSORS > 1
+  ok = esp_register_freertos_tick_hook_for_cpu(on_tick<1>, 1) == ESP_OK && ok;
+#endif
+  g_started = ok;
+  return ok;
+}
+
+uint8_t idle_pct(uint8_t core){
+  return core < portNUM_PROCESSORS ? g_cores[core].pct.load(std::memory_order_relaxed) : 255;
+}
+
+uint8_t cores(){ return portNUM_PROCESSORS; }
+
+} // namespace cpu_load
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+
+// Per-core idle share, sampled from the FreeRTOS tick: every tick each core
+// notes whether it interrupted its idle task. Costs one compare per tick and
+// needs no run-time-stats support in the SDK build.
+namespace cpu_load {
+
+bool begin();                   // install the tick hooks (once)
+uint8_t idle_pct(uint8_t core); // idle share of the last full second, 0..100; 255 until one has passed
+uint8_t cores();
+
+} // namespace cpu_load
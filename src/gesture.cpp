@@ -0,0 +1,146 @@
+#include "gesture.hpp"
+#include <stdlib.h>
+
+namespace {
+
+// CST816S gesture ids (register 0x01)
+constexpr uint8_t HW_SWIPE_UP     = 0x01;
+constexpr uint8_t HW_SWIPE_DOWN   = 0x02;
+constexpr uint8_t HW_SWIPE_LEFT   = 0x03;
+constexpr uint8_t HW_SWIPE_RIGHT  = 0x04;
+constexpr uint8_t HW_CLICK        = 0x05;
+constexpr uint8_t HW_DOUBLE_CLICK = 0x0B;
+constexpr uint8_t HW_LONG_PRESS   = 0x0C;
+
+gesture::Kind from_hw(uint8_t id){
+  switch(id){
+    case HW_SWIPE_UP:     return gesture::Kind::SwipeUp;
+    case HW_SWIPE_DOWN:   return gesture::Kind::SwipeDown;
+    case HW_SWIPE_LEFT:   return gesture::Kind::SwipeLeft;
+    case HW_SWIPE_RIGHT:  return gesture::Kind::SwipeRight;
+    case HW_CLICK:        return gesture::Kind::Tap;
+    case HW_DOUBLE_CLICK: return gesture::Kind::DoubleTap;
+    case HW_LONG_PRESS:   return gesture::Kind::LongPress;
+  }
+  return gesture::Kind::None;
+}
+
+} // anon
+
+namespace gesture {
+
+bool Recognizer::is_swipe(int32_t dist, uint32_t dt_us) const {
+  if(dist >= cfg_.swipe_far_px) return true;
+  if(dist < cfg_.swipe_min_px) return false;
+  // dist / dt >= px_s, without the division
+  return (uint64_t)dist * 1000000ULL >= (uint64_t)cfg_.swipe_px_s * (dt_us ? dt_us : 1);
+}
+
+void Recognizer::push(const Event& ev){
+  if(outLen_ == sizeof(out_) / sizeof(out_[0])) return;   // can't happen: at most 4 per sample
+  out_[(outHead_ + outLen_) % 4] = ev;
+  outLen_++;
+}
+
+bool Recognizer::next(Event& ev){
+  if(!outLen_) return false;
+  ev = out_[outHead_];
+  outHead_ = (outHead_ + 1) % 4;
+  outLen_--;
+  return true;
+}
+
+void Recognizer::edge(Kind k, const touch::Sample& s){
+  push(Event{ k, Source::Software, seq_, s.t_us, (int16_t)s.x, (int16_t)s.y, 0 });
+}
+
+void Recognizer::flush_tap(uint32_t now_us){
+  if(!tapPending_) return;
+  tapPending_ = false;
+  tap_.wait_us = now_us - tap_.t_us;
+  push(tap_);
+}
+
+void Recognizer::decide(Kind k, Source src, uint32_t t_us){
+  decided_ = true;
+  Event ev{ k, src, seq_, t_us, x0_, y0_, 0 };
+  if(secondTap_){
+    secondTap_ = false;
+    if(k == Kind::Tap){ tapPending_ = false; ev.kind = Kind::DoubleTap; push(ev); return; }
+    flush_tap(t_us);   // the second touch was something else; the first tap still counts
+  }
+  if(k == Kind::None) return;
+  if(k == Kind::Tap && cfg_.double_tap_ms){ tap_ = ev; tapPending_ = true; return; }
+  push(ev);
+}
+
+void Recognizer::feed(const touch::Sample& s){
+  if(!down_){
+    if(!s.down){
+      // A quick tap can reach us as a single release report carrying the click id,
+      // but right after a Release that id is the controller catching up on the last gesture.
+      if(!(cfg_.use_hw && from_hw(s.gesture) != Kind::None)) return;
+      if(ended_ && (s.t_us - endT_) < cfg_.late_hw_ms * 1000UL){ suppressed_++; return; }
+    }
+    ended_ = false;
+    if(tapPending_){
+      const bool close = abs((int32_t)s.x - tap_.x) <= cfg_.swipe_far_px && abs((int32_t)s.y - tap_.y) <= cfg_.swipe_far_px;
+      if(close && (s.t_us - tap_.t_us) < cfg_.double_tap_ms * 1000UL) secondTap_ = true;
+      else flush_tap(s.t_us);
+    }
+    down_ = true;
+    decided_ = false;
+    seq_++;
+    t0_ = s.t_us;
+    x0_ = (int16_t)s.x; y0_ = (int16_t)s.y;
+    maxDist_ = 0;
+    // the gesture register keeps its last value until the controller classifies again
+    hwLast_ = s.down ? s.gesture : 0;
+    edge(Kind::Press, s);
+  }
+
+  const int32_t dx = (int32_t)s.x - x0_;
+  const int32_t dy = (int32_t)s.y - y0_;
+  const int32_t dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+  if(s.down && dist > maxDist_) maxDist_ = dist;
+
+  // 1) the controller's classification, as soon as it shows up
+  Kind hw = Kind::None;
+  if(s.gesture != hwLast_){
+    hwLast_ = s.gesture;
+    if(cfg_.use_hw) hw = from_hw(s.gesture);
+  }
+  if(decided_){
+    if(hw != Kind::None) suppressed_++;   // e.g. the controller's click after our own swipe
+  }else if(hw != Kind::None){
+    decide(hw, Source::Hardware, s.t_us);
+  }else if(is_swipe(dist, s.t_us - t0_)){
+    // 2) software fallback: swipe as soon as distance and speed say so, tap on release
+    Kind k = abs(dx) >= abs(dy) ? (dx < 0 ? Kind::SwipeLeft : Kind::SwipeRight)
+                                : (dy < 0 ? Kind::SwipeUp   : Kind::SwipeDown);
+    decide(k, Source::Software, s.t_us);
+  }else if(!s.down){
+    if(maxDist_ <= cfg_.tap_slop_px && (s.t_us - t0_) < cfg_.long_press_ms * 1000UL)
+      decide(Kind::Tap, Source::Software, s.t_us);
+    else
+      decide(Kind::None, Source::Software, s.t_us);   // moved too far for a tap, too little for a swipe
+  }
+
+  if(!s.down){
+    down_ = false;
+    secondTap_ = false;
+    ended_ = true;
+    endT_ = s.t_us;
+    edge(Kind::Release, s);
+  }
+}
+
+void Recognizer::poll(uint32_t now_us){
+  if(tapPending_ && !secondTap_ && (now_us - tap_.t_us) >= cfg_.double_tap_ms * 1000UL) flush_tap(now_us);
+  if(!down_ || decided_) return;
+  if(maxDist_ > cfg_.tap_slop_px) return;
+  if((now_us - t0_) < cfg_.long_press_ms * 1000UL) return;
+  decide(Kind::LongPress, Source::Software, now_us);
+}
+
+} // namespace gesture
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include "touch_sample.hpp"
+
+// Turns touch samples into taps, long presses and swipes. The CST816S gesture
+// engine is trusted first (its id rides along with every sample); the
+// distance/speed rules below only decide when the controller hasn't. Samples
+// are expected to be filtered already (touch::Filter). One
+// finger-down..finger-up sequence yields at most one gesture event, bracketed
+// by Press and Release edges.
+namespace gesture {
+
+enum class Kind : uint8_t { None, Tap, DoubleTap, LongPress, SwipeLeft, SwipeRight, SwipeUp, SwipeDown,
+                           Press, Release };   // finger edges
+enum class Source : uint8_t { Hardware, Software };
+
+struct Event {
+  Kind kind;
+  Source src;
+  uint32_t seq;      // gesture number, one gesture event per value at most
+  uint32_t t_us;     // timestamp of the sample that decided it
+  int16_t x, y;      // where the finger went down
+  uint32_t wait_us;  // how long a tap was held back waiting for a second one
+};
+
+struct Config {
+  bool     use_hw        = true;  // accept controller gesture ids
+  uint16_t tap_slop_px   = 12;    // further than this and it's no longer a tap
+  // Software swipes: a quick flick counts early, a slow drag only once it's gone far
+  uint16_t swipe_min_px  = 20;    // shortest swipe, if it's fast enough
+  uint16_t swipe_far_px  = 40;    // always a swipe past this, whatever the speed
+  uint16_t swipe_px_s    = 300;   // average speed since touch-down that makes a short move a swipe
+  uint32_t long_press_ms = 700;
+  uint32_t double_tap_ms = 0;     // 0: taps go out immediately; otherwise wait this long for a second tap
+  uint32_t late_hw_ms    = 150;   // a release-only classification this soon after a Release belongs to that gesture
+};
+
+class Recognizer {
+public:
+  explicit Recognizer(const Config& cfg = Config()) : cfg_(cfg) {}
+  void configure(const Config& cfg) { cfg_ = cfg; }
+  const Config& config() const { return cfg_; }
+
+  // Feed samples in order, then drain next().
+  void feed(const touch::Sample& s);
+  // Time-driven decisions (long press, end of the double-tap window); call every frame.
+  void poll(uint32_t now_us);
+  bool next(Event& ev);
+  bool down() const { return down_; }
+  bool busy() const { return down_ || tapPending_; }   // poll() may still produce an event
+  uint32_t gestures() const { return seq_; }
+  uint32_t suppressed() const { return suppressed_; }  // classifications after the gesture was decided or ended
+
+private:
+  void decide(Kind k, Source src, uint32_t t_us);
+  bool is_swipe(int32_t dist, uint32_t dt_us) const;
+  void edge(Kind k, const touch::Sample& s);
+  void flush_tap(uint32_t now_us);
+  void push(const Event& ev);
+
+  Config cfg_;
+  bool down_ = false;
+  bool decided_ = false;   // this gesture already produced its event
+  bool ended_ = false;     // a Release went out and no finger has touched since
+  uint32_t endT_ = 0;
+  uint8_t hwLast_ = 0;     // gesture register as last seen; only changes are classifications
+  uint32_t seq_ = 0;
+  uint32_t suppressed_ = 0;
+  uint32_t t0_ = 0;
+  int16_t x0_ = 0, y0_ = 0;
+  int32_t maxDist_ = 0;
+
+  bool tapPending_ = false;  // a tap waiting out the double-tap window
+  bool secondTap_ = false;   // the current gesture started inside that window
+  Event tap_{};
+
+  Event out_[4];
+  uint8_t outHead_ = 0, outLen_ = 0;
+};
+
+} // namespace gesture
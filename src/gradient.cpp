@@ -0,0 +1,93 @@
+#include "gradient.hpp"
+#include "lvgl_hal.h"
+
+namespace gradient {
+
+constexpr uint16_t kRows  = TFT_HEIGHT;
+constexpr size_t   kSlots = 8;   // three bound macro pages need three; the rest keep recent pairs warm
+
+struct Table {
+  uint32_t top, bottom;
+  uint8_t  refs;
+  uint32_t used;                 // acquire stamp, oldest unreferenced table is reused first
+  bool     valid;
+  lv_color_t rows[kRows];
+};
+
+namespace {
+
+Table g_tables[kSlots]{};
+uint32_t g_stamp = 0;
+Stats g_stats{};
+
+lv_color_t rgb(uint32_t c){ return lv_color_make((c >> 16) & 255, (c >> 8) & 255, c & 255); }
+
+void build(Table& t, uint32_t top, uint32_t bottom){
+  const lv_color_t c1 = rgb(top), c2 = rgb(bottom);
+  for(uint16_t y = 0; y < kRows; ++y) t.rows[y] = lv_color_mix(c2, c1, (uint8_t)(y * 255 / (kRows - 1)));
+  t.top = top;
+  t.bottom = bottom;
+  t.valid = true;
+  g_stats.built++;
+}
+
+} // anon
+
+const Table* acquire(uint32_t top, uint32_t bottom){
+  Table* hit = nullptr;
+  Table* victim = nullptr;
+  for(auto& t : g_tables){
+    if(t.valid && t.top == top && t.bottom == bottom){ hit = &t; break; }
+    if(t.refs) continue;
+    if(!victim || (victim->valid && (!t.valid || t.used < victim->used))) victim = &t;
+  }
+  if(hit){
+    g_stats.shared++;
+  }else{
+    if(!victim) return nullptr;
+    build(*victim, top, bottom);
+    hit = victim;
+  }
+  hit->refs++;
+  hit->used = ++g_stamp;
+  return hit;
+}
+
+void release(const Table* t){
+  for(auto& e : g_tables) if(&e == t && e.refs){ e.refs--; return; }
+}
+
+void paint(lv_event_t* e, const Table* t){
+  lv_obj_t* obj = lv_event_get_target(e);
+  const lv_area_t& box = obj->coords;
+  const lv_event_code_t code = lv_event_get_code(e);
+
+  if(code == LV_EVENT_COVER_CHECK){
+    lv_cover_check_info_t* info = (lv_cover_check_info_t*)lv_event_get_param(e);
+    if(info->res != LV_COVER_RES_MASKED && _lv_area_is_in(info->area, &box, 0)) info->res = LV_COVER_RES_COVER;
+    return;
+  }
+  if(code != LV_EVENT_DRAW_MAIN) return;
+
+  // Straight into the render buffer: one lv_color_fill per visible row of the clip area.
+  lv_draw_ctx_t* dc = lv_event_get_draw_ctx(e);
+  lv_area_t a;
+  if(!_lv_area_intersect(&a, dc->clip_area, &box)) return;
+  const lv_coord_t stride = lv_area_get_width(dc->buf_area);
+  const lv_coord_t w = lv_area_get_width(&a);
+  const lv_coord_t h = lv_area_get_height(&box);
+  lv_color_t* row = (lv_color_t*)dc->buf + (a.y1 - dc->buf_area->y1) * stride + (a.x1 - dc->buf_area->x1);
+  for(lv_coord_t y = a.y1; y <= a.y2; ++y, row += stride){
+    const int32_t i = h == kRows ? y - box.y1 : (int32_t)(y - box.y1) * (kRows - 1) / LV_MAX(h - 1, 1);
+    lv_color_fill(row, t->rows[i], w);
+  }
+}
+
+Stats stats(){
+  Stats s = g_stats;
+  s.in_use = 0;
+  for(auto& t : g_tables) if(t.refs) s.in_use++;
+  return s;
+}
+
+} // namespace gradient
@@ -0,0 +1,29 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+
+// Vertical background gradients from precomputed row tables. LVGL rebuilds a
+// gradient's colours on every redraw (no gradient cache in this build), even
+// when only a few pixels of the page changed; here each colour pair is blended
+// once into one RGB565 entry per panel row and a redraw just fills rows.
+namespace gradient {
+
+struct Table;
+
+// Shared table for a top -> bottom blend (0xRRGGBB); nullptr if every slot is taken.
+const Table* acquire(uint32_t top, uint32_t bottom);
+void release(const Table* t);   // nullptr is fine
+
+// Event handler body for an object whose background comes from `t`: paints it on
+// LV_EVENT_DRAW_MAIN and reports it opaque on LV_EVENT_COVER_CHECK, so nothing
+// underneath is drawn first. The object's own bg_opa must be transparent.
+void paint(lv_event_t* e, const Table* t);
+
+struct Stats {
+  uint32_t built;     // tables blended
+  uint32_t shared;    // acquires served by an existing table
+  uint32_t in_use;
+};
+Stats stats();
+
+} // namespace gradient
@@ -0,0 +1,157 @@
+#include "input.hpp"
+#include "lvgl_hal.h"
+#include "touch.hpp"
+#include "lf_queue.hpp"
+extern "C" {
+  #include "esp_timer.h"
+}
+
+namespace {
+
+constexpr size_t kQueueLen   = 8;
+constexpr size_t kEdgeReserve = 2;   // slots only Press/Release may take
+
+gesture::Recognizer g_recognizer;
+LfQueue<gesture::Event, kQueueLen> g_events;
+input::Sink g_sink = nullptr;
+input::Stats g_stats{};
+uint32_t g_lastSeq = 0;        // last gesture delivered
+bool     g_held = false;       // a Press went out without its Release yet
+bool     g_edgeLost = false;   // an edge didn't fit; g_held is re-synced once the queue drains
+uint32_t g_suppressed = 0;     // dispatcher's own share of Stats::suppressed
+
+// Per-target tap timing: what the double-tap window costs each page that has one.
+// Only pages with a window get an entry; the least recently shown one makes room,
+// which also ages out handles a profile reload has retired.
+constexpr size_t kMaxTargets = 32;
+input::TargetStats g_targets[kMaxTargets];
+uint32_t g_lastUsed[kMaxTargets];
+size_t   g_nTargets = 0;
+uint32_t g_useClock = 0;
+input::TargetStats* g_current = nullptr;
+
+input::TargetStats* target_for(uint32_t id){
+  size_t slot = kMaxTargets, oldest = 0;
+  for(size_t i = 0; i < g_nTargets && slot == kMaxTargets; ++i){
+    if(g_targets[i].target == id) slot = i;
+    else if(g_lastUsed[i] < g_lastUsed[oldest]) oldest = i;
+  }
+  if(slot == kMaxTargets){
+    slot = g_nTargets < kMaxTargets ? g_nTargets++ : oldest;
+    g_targets[slot] = input::TargetStats{ id, 0, 0, 0, 0, 0 };
+  }
+  g_lastUsed[slot] = ++g_useClock;
+  return &g_targets[slot];
+}
+
+input::TargetStats* current_target(){ return g_current; }
+
+void note_tap(uint32_t wait_us){
+  input::TargetStats* t = current_target();
+  if(!t) return;
+  t->taps++;
+  t->wait_total_us += wait_us;
+  if(wait_us > t->wait_max_us) t->wait_max_us = wait_us;
+  t->window_ms = g_recognizer.config().double_tap_ms;
+}
+
+void note_double(){
+  if(input::TargetStats* t = current_target()) t->double_taps++;
+}
+
+bool is_edge(gesture::Kind k){ return k == gesture::Kind::Press || k == gesture::Kind::Release; }
+
+// Gestures give way to edges: a lost Release would leave a hold-through key down
+// and make the next Press look like a duplicate.
+void queue(const gesture::Event& ev){
+  const bool edge = is_edge(ev.kind);
+  if(!edge && g_events.size() >= kQueueLen - kEdgeReserve){ g_stats.dropped++; return; }
+  if(!g_events.push(ev)){
+    g_stats.dropped++;
+    if(edge) g_edgeLost = true;
+  }
+}
+
+// Runs inside LVGL's indev read, so it only classifies; delivery waits for dispatch().
+void on_sample(const touch::Sample& s){
+  g_recognizer.feed(s);
+  gesture::Event ev;
+  while(g_recognizer.next(ev)) queue(ev);
+}
+
+void count(const gesture::Event& ev){
+  switch(ev.kind){
+    case gesture::Kind::Tap:       g_stats.taps++; break;
+    case gesture::Kind::DoubleTap: g_stats.double_taps++; break;
+    case gesture::Kind::LongPress: g_stats.long_presses++; break;
+    case gesture::Kind::None:
+    case gesture::Kind::Press:
+    case gesture::Kind::Release:   break;
+    default:                       g_stats.swipes++; break;
+  }
+  if(ev.src == gesture::Source::Hardware) g_stats.hardware++;
+}
+
+void deliver(const gesture::Event& ev){
+  if(is_edge(ev.kind)){
+    const bool press = ev.kind == gesture::Kind::Press;
+    if(press == g_held){ g_suppressed++; return; }    // edges strictly alternate
+    g_held = press;
+  }else{
+    if(ev.seq == g_lastSeq){ g_suppressed++; return; } // this gesture already acted
+    g_lastSeq = ev.seq;
+  }
+  const uint32_t lat = (uint32_t)esp_timer_get_time() - ev.t_us;
+  g_stats.last_latency_us = lat;
+  if(lat > g_stats.worst_latency_us) g_stats.worst_latency_us = lat;
+  g_stats.delivered++;
+  count(ev);
+  if(ev.kind == gesture::Kind::Tap) note_tap(ev.wait_us);
+  else if(ev.kind == gesture::Kind::DoubleTap) note_double();
+  if(g_sink) g_sink(ev);
+}
+
+} // anon
+
+namespace input {
+
+void begin(Sink sink){
+  g_sink = sink;
+  lvgl_hal_on_touch(on_sample);
+}
+
+void dispatch(){
+  gesture::Event ev;
+  g_recognizer.poll((uint32_t)esp_timer_get_time());
+  while(g_recognizer.next(ev)) queue(ev);
+  while(g_events.pop(ev)) deliver(ev);
+  if(g_edgeLost && g_events.empty()){
+    // the sink sees the finger as the recognizer does before anything else goes out
+    g_edgeLost = false;
+    if(g_held != g_recognizer.down()){
+      deliver(gesture::Event{ g_held ? gesture::Kind::Release : gesture::Kind::Press, gesture::Source::Software,
+                              g_recognizer.gestures(), (uint32_t)esp_timer_get_time(), 0, 0, 0 });
+    }
+  }
+  g_stats.gestures = g_recognizer.gestures();
+  g_stats.suppressed = g_suppressed + g_recognizer.suppressed() + touch::stats().repeats;
+}
+
+bool busy(){ return g_recognizer.busy() || !g_events.empty(); }
+
+void set_target(uint32_t id, uint32_t double_tap_ms){
+  g_current = (id && double_tap_ms) ? target_for(id) : nullptr;
+  gesture::Config cfg = g_recognizer.config();
+  cfg.double_tap_ms = double_tap_ms;
+  g_recognizer.configure(cfg);
+}
+
+Stats stats(){ return g_stats; }
+
+size_t target_stats(TargetStats* out, size_t max){
+  size_t n = g_nTargets < max ? g_nTargets : max;
+  for(size_t i = 0; i < n; ++i) out[i] = g_targets[i];
+  return n;
+}
+
+} // namespace input
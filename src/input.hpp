@@ -0,0 +1,45 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "gesture.hpp"
+
+// The one path from the touch controller to the UI. Samples are classified by
+// a single gesture::Recognizer and each gesture is delivered at most once, in
+// order, on the LVGL task, between a Press and a Release edge. Nothing else may
+// turn presses into actions.
+namespace input {
+
+using Sink = void (*)(const gesture::Event&);
+
+struct Stats {
+  uint32_t gestures;          // finger-down..up sequences seen
+  uint32_t delivered;         // events handed to the sink, edges included
+  uint32_t taps, double_taps, long_presses, swipes;
+  uint32_t hardware;          // delivered events classified by the controller
+  uint32_t suppressed;        // duplicates stopped: late classifications, repeated reports, replayed gesture ids
+  uint32_t dropped;           // events lost to a full queue
+  uint32_t last_latency_us;   // deciding sample -> delivery
+  uint32_t worst_latency_us;
+};
+
+// Taps held back for a double tap, per target (the UI uses slot handles).
+struct TargetStats {
+  uint32_t target;
+  uint32_t taps;
+  uint32_t double_taps;
+  uint32_t wait_total_us;     // added latency summed over taps
+  uint32_t wait_max_us;
+  uint32_t window_ms;         // window in force at the last tap
+};
+
+void begin(Sink sink);   // LVGL task; hooks the touch driver
+void dispatch();         // LVGL task, after lv_timer_handler(): long-press timing + delivery
+bool busy();             // dispatch() still has timing to do (finger down, tap held back) or events queued
+// What the visible page listens for: `id` names it in target_stats(), a non-zero
+// window holds single taps back that long in case a second one follows. Only
+// pages with a window are tracked, up to 32, least recently shown evicted first.
+void set_target(uint32_t id, uint32_t double_tap_ms);
+Stats stats();
+size_t target_stats(TargetStats* out, size_t max);
+
+} // namespace input
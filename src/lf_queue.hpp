@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded lock-free queue (Vyukov's sequence-numbered ring). Any number of
+// producers, one consumer. push() never blocks and fails when the ring is full,
+// so it is safe to call from tasks that must not wait on the consumer.
+template <typename T, size_t N>
+class LfQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    T data;
+  };
+
+  Cell cells_[N];
+  std::atomic<uint32_t> head_{0};  // next slot to write
+  std::atomic<uint32_t> tail_{0};  // next slot to read
+
+public:
+  LfQueue() {
+    for (size_t i = 0; i < N; ++i) cells_[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+  }
+
+  bool push(const T& v) {
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& c = cells_[pos & (N - 1)];
+      int32_t dif = (int32_t)(c.seq.load(std::memory_order_acquire) - pos);
+      if (dif == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          c.data = v;
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false;  // full
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool pop(T& out) {  // consumer only
+    uint32_t pos = tail_.load(std::memory_order_relaxed);
+    Cell& c = cells_[pos & (N - 1)];
+    if ((int32_t)(c.seq.load(std::memory_order_acquire) - (pos + 1)) < 0) return false;  // empty
+    out = c.data;
+    c.seq.store(pos + N, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+  size_t size() const {  // exact on the consumer while no push is in flight
+    return (uint32_t)(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+  }
+};
@@ -1,12 +1,18 @@
 #include "lvgl_hal.h"
 #include "pinout.h"
+#include "touch.hpp"
+#include "render_stats.hpp"
+#include "backlight.hpp"
+#include "splash.hpp"
 
 extern "C" {
   #include "esp_timer.h"
 }
-static esp_timer_handle_t lvgl_tick_timer = nullptr;
 
 static bool isTouched = false;
+static lv_color_t *shadow_fb = nullptr;
+static void (*touch_hook)(const touch::Sample &) = nullptr;
+lv_indev_t *ts_cst816s_indev = nullptr;
 
 TFT_eSPI tft_gc9a01 = TFT_eSPI();
 #ifdef CST816S_SUPPORT
@@ -18,32 +24,50 @@ void usr_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *colo
 {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
+  const int64_t t0 = esp_timer_get_time();
 
   tft_gc9a01.startWrite();
   tft_gc9a01.setAddrWindow(area->x1, area->y1, w, h);
   tft_gc9a01.pushColors((uint16_t *)&color_p->full, w * h, true);
   tft_gc9a01.endWrite();
 
+  // keep a copy of what the panel shows (page transitions start from it)
+  if (shadow_fb)
+  {
+    lv_color_t *dst = shadow_fb + area->y1 * TFT_WIDTH + area->x1;
+    for (uint32_t y = 0; y < h; y++)
+      memcpy(dst + y * TFT_WIDTH, color_p + y * w, w * sizeof(lv_color_t));
+  }
+
+  render_stats::on_flush((uint32_t)(esp_timer_get_time() - t0));
   lv_disp_flush_ready(disp);
 }
 
+const lv_color_t *lvgl_hal_framebuffer(void)
+{
+  return shadow_fb;
+}
+
 #ifdef CST816S_SUPPORT
 extern "C" void touch_idle_time_clear() { /* no-op stub */ }
+// Drains samples queued by the touch task; never touches I2C.
 void usr_touchpad_read(struct _lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
-  static touch_event_t event;
-  static bool lastTouch = false;
+  static touch::Sample last{};
+  touch::Sample s;
 
-  if (ts_cst816s.ready())
+  if (touch::read(s))
   {
-    ts_cst816s.getTouch(&event);
-    Serial.printf("Touch event: finger=%d x=%d y=%d\n", event.finger, event.x, event.y);
+    last = s;
+    if (touch_hook)
+      touch_hook(s);
+    data->continue_reading = touch::pending(); // replay every queued sample, press/release edges included
   }
-  if (event.finger)
+  data->point.x = last.x;
+  data->point.y = last.y;
+  if (last.down)
   {
     data->state = LV_INDEV_STATE_PR;
-    data->point.x = event.x;
-    data->point.y = event.y;
     touch_idle_time_clear();
     isTouched = true;
   }
@@ -51,59 +75,38 @@ void usr_touchpad_read(struct _lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
   {
     data->state = LV_INDEV_STATE_REL;
     isTouched = false;
+    // nothing to poll until the next sample: lvgl_hal_touch_kick() restarts the read timer
+    if (!data->continue_reading)
+      lv_timer_pause(indev_drv->read_timer);
   }
 }
 #endif
 
-static int8_t aw9346_from_light = -1;
-
-void tft_backlight_init(void)
+void lvgl_hal_on_touch(void (*cb)(const touch::Sample &))
 {
-  pinMode(LCD_BL_PIN, OUTPUT);
-  digitalWrite(LCD_BL_PIN, LOW);
-  delay(3); // > 2.5ms for shutdown
-  aw9346_from_light = 0;
+  touch_hook = cb;
 }
-void tft_set_backlight(int8_t aw9346_to_light)
-{
-  if (aw9346_to_light > 16)
-    aw9346_to_light = 16;
-  if (aw9346_to_light < 0)
-    aw9346_to_light = 0;
-  if (aw9346_from_light == aw9346_to_light)
-    return;
-
-  if (aw9346_to_light == 0)
-  {
-    digitalWrite(LCD_BL_PIN, LOW);
-    delay(3); // > 2.5ms for shutdown
-    aw9346_from_light = 0;
-    return;
-  }
-  if (aw9346_from_light <= 0)
-  {
-    digitalWrite(LCD_BL_PIN, HIGH);
-    delayMicroseconds(25); // > 20us for poweron
-    aw9346_from_light = 16;
-  }
 
-  if (aw9346_from_light < aw9346_to_light)
-    aw9346_from_light += 16;
-
-  int8_t num = aw9346_from_light - aw9346_to_light;
-
-  for (int8_t i = 0; i < num; i++)
+void lvgl_hal_touch_kick(void)
+{
+#ifdef CST816S_SUPPORT
+  if (ts_cst816s_indev)
   {
-    digitalWrite(LCD_BL_PIN, LOW);
-    delayMicroseconds(1); // 0.5us < T_low < 500us
-    digitalWrite(LCD_BL_PIN, HIGH);
-    delayMicroseconds(1); // 0.5us < T_high
+    lv_timer_resume(ts_cst816s_indev->driver->read_timer);
+    lv_timer_ready(ts_cst816s_indev->driver->read_timer);
   }
+#endif
+}
 
-  aw9346_from_light = aw9346_to_light;
+void tft_backlight_init(void)
+{
+  backlight::begin();
+}
+void tft_set_backlight(int8_t light)
+{
+  backlight::set(light < 0 ? 0 : (uint8_t)light);
 }
 
-lv_indev_t *ts_cst816s_indev;
 void lvgl_hal_init(void)
 {
   // ----------- ADD I2C STARTUP AND TOUCH RESET AT THE VERY BEGINNING: -------------
@@ -122,11 +125,13 @@ void lvgl_hal_init(void)
   ts_cst816s.begin();
   Serial.println("Touch begin called"); // Debug!
   ts_cst816s.setReportRate(2);          // 20ms
-  ts_cst816s.setReportMode(0x60);       // touch + gesture generated interrupt
+  ts_cst816s.setReportMode(0x71);       // touch + gesture generated interrupt
   ts_cst816s.setMotionMask(0);          // disable motion
   ts_cst816s.setAutoRst(0);             // disable auto reset
   ts_cst816s.setLongRst(0);             // disable long press reset
   ts_cst816s.setDisAutoSleep(1);        // disable auto sleep
+  Wire.setClock(I2C0_SPEED);
+  touch::begin(ts_cst816s);
 #endif
 
   // display
@@ -134,7 +139,15 @@ void lvgl_hal_init(void)
   tft_gc9a01.invertDisplay(1);
   // tft_gc9a01.setRotation(2);
 
-  tft_gc9a01.fillScreen(TFT_BLACK);
+  // Last frame of the previous run, if saved; the shadow buffer then holds it too
+  if (!shadow_fb)
+    shadow_fb = (lv_color_t *)ps_malloc(TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t));
+  if (!splash::show(shadow_fb))
+  {
+    tft_gc9a01.fillScreen(TFT_BLACK);
+    if (shadow_fb)
+      memset(shadow_fb, 0, TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t));
+  }
   tft_backlight_init();
   delay(50);
   tft_set_backlight(16);
@@ -144,19 +157,7 @@ void lvgl_hal_init(void)
   // must static
   static lv_disp_draw_buf_t draw_buf;
   static lv_color_t *color_buf = (lv_color_t *)LV_MEM_CUSTOM_ALLOC(TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t));
-  lv_init();
-  if (!lvgl_tick_timer) {
-    const esp_timer_create_args_t args = {
-      .callback = [](void*){
-        lv_tick_inc(1);
-      },
-      .arg = nullptr,
-      .dispatch_method = ESP_TIMER_TASK,
-      .name = "lvgl_tick"
-    };
-    esp_timer_create(&args, &lvgl_tick_timer);
-    esp_timer_start_periodic(lvgl_tick_timer, 1000); // 1 ms
-  }
+  lv_init(); // tick: LV_TICK_CUSTOM reads esp_timer, nothing to start
   lv_disp_draw_buf_init(&draw_buf, color_buf, NULL, TFT_WIDTH * TFT_HEIGHT);
 
   /*Initialize the display*/
@@ -167,6 +168,8 @@ void lvgl_hal_init(void)
   disp_drv.hor_res = TFT_WIDTH;
   disp_drv.ver_res = TFT_HEIGHT;
   disp_drv.flush_cb = usr_disp_flush;
+  disp_drv.render_start_cb = [](lv_disp_drv_t *) { render_stats::on_render_start(); };
+  disp_drv.monitor_cb = [](lv_disp_drv_t *, uint32_t, uint32_t px) { render_stats::on_frame_done(px); };
   disp_drv.draw_buf = &draw_buf;
   lv_disp_drv_register(&disp_drv);
   // lv_disp_set_rotation(NULL, LV_DISP_ROT_180);
@@ -176,8 +179,7 @@ void lvgl_hal_init(void)
   // must static
   static lv_indev_drv_t indev_drv;
   lv_indev_drv_init(&indev_drv); /*Basic initialization*/
-  indev_drv.gesture_limit = 1;
-  indev_drv.gesture_min_velocity = 1;
+  indev_drv.gesture_min_velocity = UINT8_MAX; // LVGL's detector off: gestures come from gesture::Recognizer
   indev_drv.type = LV_INDEV_TYPE_POINTER; /*See below.*/
   indev_drv.read_cb = usr_touchpad_read;  /*See below.*/
   /*Register the driver in LVGL and save the created input device object*/
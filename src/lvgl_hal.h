@@ -8,8 +8,19 @@
 
 #include "knomi.h"
 #include "lvgl.h"
+#include "touch_sample.hpp"
+
+extern TFT_eSPI tft_gc9a01;
 
 void lvgl_hal_init(void);
 void tft_set_backlight(int8_t light);
 
+// Make the touch driver read on the next lv_timer_handler() pass (a sample just arrived)
+void lvgl_hal_touch_kick(void);
+// Called on the LVGL task with every touch sample, in order, before LVGL sees it
+void lvgl_hal_on_touch(void (*cb)(const touch::Sample &));
+
+// Shadow copy of the panel contents (TFT_WIDTH x TFT_HEIGHT), kept up to date by the flush callback
+const lv_color_t *lvgl_hal_framebuffer(void);
+
 #endif
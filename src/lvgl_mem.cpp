@@ -0,0 +1,136 @@
+#include "lvgl_mem.h"
+#include <string.h>
+#include <esp32-hal-psram.h>
+extern "C" {
+  #include "esp_heap_caps.h"
+}
+
+namespace {
+
+constexpr size_t   kArenaBytes = 32 * 1024;
+constexpr size_t   kPageBytes  = 1024;      // pages are given to a size class for good
+constexpr size_t   kPages      = kArenaBytes / kPageBytes;
+constexpr uint16_t kClasses[]  = {16, 24, 32, 48, 64, 96, 128, 192, LVGL_MEM_SMALL_MAX};
+constexpr size_t   kNumClasses = sizeof(kClasses) / sizeof(kClasses[0]);
+constexpr size_t   kHeader     = 8;         // PSRAM blocks carry their size; keeps 8-byte alignment
+
+struct FreeBlock { FreeBlock* next; };
+
+uint8_t*   g_arena = nullptr;
+bool       g_arenaTried = false;
+size_t     g_pagesUsed = 0;
+uint8_t    g_pageClass[kPages];
+FreeBlock* g_free[kNumClasses] = {};
+lvgl_mem_stats_t g_stats{};
+
+int class_of(size_t n){
+  for(size_t c = 0; c < kNumClasses; ++c) if(n <= kClasses[c]) return (int)c;
+  return -1;
+}
+
+bool in_arena(const void* p){
+  return g_arena && (const uint8_t*)p >= g_arena && (const uint8_t*)p < g_arena + kArenaBytes;
+}
+
+// First LVGL allocation happens in lv_init(), long after the heap is up.
+bool arena(){
+  if(!g_arenaTried){
+    g_arenaTried = true;
+    g_arena = (uint8_t*)heap_caps_malloc(kArenaBytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(g_arena) g_stats.arena_bytes = kArenaBytes;
+  }
+  return g_arena != nullptr;
+}
+
+void* small_alloc(int c){
+  if(!g_free[c]){
+    if(!arena() || g_pagesUsed == kPages) return nullptr;
+    uint8_t* page = g_arena + g_pagesUsed * kPageBytes;
+    g_pageClass[g_pagesUsed++] = (uint8_t)c;
+    g_stats.arena_used += kPageBytes;
+    const size_t n = kPageBytes / kClasses[c];
+    for(size_t i = n; i-- > 0;){
+      FreeBlock* b = (FreeBlock*)(page + i * kClasses[c]);
+      b->next = g_free[c];
+      g_free[c] = b;
+    }
+  }
+  FreeBlock* b = g_free[c];
+  g_free[c] = b->next;
+  g_stats.small_bytes += kClasses[c];
+  g_stats.small_blocks++;
+  return b;
+}
+
+size_t small_size(const void* p){ return kClasses[g_pageClass[((const uint8_t*)p - g_arena) / kPageBytes]]; }
+
+void small_free(void* p){
+  const int c = g_pageClass[((uint8_t*)p - g_arena) / kPageBytes];
+  FreeBlock* b = (FreeBlock*)p;
+  b->next = g_free[c];
+  g_free[c] = b;
+  g_stats.small_bytes -= kClasses[c];
+  g_stats.small_blocks--;
+}
+
+void* large_alloc(size_t n){
+  uint8_t* raw = (uint8_t*)ps_malloc(n + kHeader);
+  if(!raw) return nullptr;
+  *(uint32_t*)raw = (uint32_t)n;
+  g_stats.large_bytes += n;
+  g_stats.large_blocks++;
+  if(g_stats.large_bytes > g_stats.large_peak) g_stats.large_peak = g_stats.large_bytes;
+  return raw + kHeader;
+}
+
+size_t large_size(const void* p){ return *(const uint32_t*)((const uint8_t*)p - kHeader); }
+
+void large_free(void* p){
+  g_stats.large_bytes -= large_size(p);
+  g_stats.large_blocks--;
+  free((uint8_t*)p - kHeader);
+}
+
+} // anon
+
+extern "C" void* lvgl_mem_alloc(size_t size){
+  const int c = class_of(size);
+  if(c >= 0){
+    if(void* p = small_alloc(c)) return p;
+    g_stats.fallbacks++;
+  }
+  return large_alloc(size);
+}
+
+extern "C" void lvgl_mem_free(void* p){
+  if(!p) return;
+  if(in_arena(p)) small_free(p);
+  else large_free(p);
+}
+
+// Stays put when the block's class already fits; otherwise moves, possibly across tiers.
+extern "C" void* lvgl_mem_realloc(void* p, size_t size){
+  if(!p) return lvgl_mem_alloc(size);
+  const bool small = in_arena(p);
+  const size_t old = small ? small_size(p) : large_size(p);
+  if(small && size <= old) return p;
+  if(!small && class_of(size) < 0){
+    uint8_t* raw = (uint8_t*)ps_realloc((uint8_t*)p - kHeader, size + kHeader);
+    if(!raw) return nullptr;
+    *(uint32_t*)raw = (uint32_t)size;
+    g_stats.large_bytes = g_stats.large_bytes - old + size;
+    if(g_stats.large_bytes > g_stats.large_peak) g_stats.large_peak = g_stats.large_bytes;
+    return raw + kHeader;
+  }
+  void* n = lvgl_mem_alloc(size);
+  if(!n) return nullptr;
+  memcpy(n, p, old < size ? old : size);
+  lvgl_mem_free(p);
+  return n;
+}
+
+extern "C" lvgl_mem_stats_t lvgl_mem_stats(void){
+  lvgl_mem_stats_t s = g_stats;
+  s.frag_pct = s.arena_used ? (uint8_t)(100 - (uint64_t)s.small_bytes * 100 / s.arena_used) : 0;
+  return s;
+}
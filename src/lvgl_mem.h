@@ -0,0 +1,41 @@
+#ifndef LVGL_MEM_H
+#define LVGL_MEM_H
+
+// LVGL's allocator (LV_MEM_CUSTOM in lv_conf.h), in two tiers. Requests up to
+// LVGL_MEM_SMALL_MAX bytes (objects, styles, event descriptors, timers, the hot
+// data of every tree walk) come from size-class slabs in a fixed internal SRAM
+// arena; larger ones (image decode buffers, snapshots, draw layers) and small
+// ones that no longer fit the arena go to PSRAM. LVGL task only, like the rest
+// of LVGL. Included from C.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LVGL_MEM_SMALL_MAX 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t arena_bytes;     // internal SRAM budget, 0 if it couldn't be allocated
+  uint32_t arena_used;      // bytes of arena pages handed to size classes
+  uint32_t small_bytes;     // live slab blocks, counted at their class size
+  uint32_t small_blocks;
+  uint32_t large_bytes;     // live PSRAM blocks, as requested
+  uint32_t large_blocks;
+  uint32_t large_peak;
+  uint32_t fallbacks;       // small requests that went to PSRAM because their class was out of pages
+  uint8_t  frag_pct;        // share of handed-out arena pages not holding a live block
+} lvgl_mem_stats_t;
+
+void *lvgl_mem_alloc(size_t size);
+void lvgl_mem_free(void *p);
+void *lvgl_mem_realloc(void *p, size_t size);
+lvgl_mem_stats_t lvgl_mem_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,6 @@
 #include "macros.hpp"
 #include "ble_hid.hpp"
+#include "coex.hpp"
 #include "tusb.h"
 
 #ifndef HID_KEYPAD_0
@@ -31,7 +32,8 @@ extern "C" {
 #include <tuple>
 
 namespace {
-  struct Msg { macros::Type type; String payload; };
+  enum class Op : uint8_t { Run, HoldDown, HoldUp };
+  struct Msg { macros::Type type; String payload; Op op = Op::Run; };
   static TaskHandle_t s_macroTask = nullptr;
   static QueueHandle_t s_macroQ   = nullptr;
 
@@ -39,6 +41,8 @@ namespace {
     for(;;){
       Msg* m = nullptr;
       if(xQueueReceive(s_macroQ, &m, portMAX_DELAY) == pdTRUE && m){
+        coex::macro_begin();   // BT first until the last report is out
+        if(m->op != Op::Run){ macros::run_hold(m->payload, m->op == Op::HoldDown); delete m; coex::macro_end(); continue; }
         // BLE ready guard — keeps logs you added earlier
         switch(m->type){
           case macros::Type::Keystroke: macros::run_keystroke(m->payload); break;
@@ -47,6 +51,7 @@ namespace {
           default:                      macros::run_keybind(m->payload);   break;
         }
         delete m;
+        coex::macro_end();
       }
     }
   }
@@ -130,7 +135,13 @@ void begin_async(){ ensure_worker(); }
 void enqueue(Type type, const String& payload){
   ensure_worker();
   Msg* m = new Msg{type, payload};
-  xQueueSend(s_macroQ, &m, 0);
+  if(xQueueSend(s_macroQ, &m, 0) != pdTRUE) delete m;
+}
+void enqueue_hold(const String& payload, bool down){
+  ensure_worker();
+  Msg* m = new Msg{Type::Keybind, payload, down ? Op::HoldDown : Op::HoldUp};
+  // a lost key-up would leave the key stuck on the host, so that one may wait for room
+  if(xQueueSend(s_macroQ, &m, down ? 0 : pdMS_TO_TICKS(100)) != pdTRUE) delete m;
 }
 
 using knomi::press_release;
@@ -265,6 +276,27 @@ bool parse_keybind(const String& text) {
   uint8_t key, mods; return parse_combo(text, key, mods);
 }
 
+bool can_hold(Type type, const String& payload) {
+  if (type != Type::Keybind && type != Type::Keystroke) return false;
+  String p = payload; p.trim();
+  return parse_keybind(p);
+}
+
+void run_hold(const String& payload, bool down) {
+  if (!down) { knomi::release_all(); return; }   // always let go, even if the link dropped meanwhile
+  if (!knomi::ble_ready()) {
+    Serial.println("[MACRO] BLE not ready (not connected or not subscribed) — ignoring hold");
+    return;
+  }
+  String p = payload; p.trim();
+  uint8_t key, mods;
+  if (!parse_combo(p, key, mods)) {
+    Serial.println("Invalid hold combo");
+    return;
+  }
+  send_vk(key, true, mods);
+}
+
 void run_keystroke(const String& text) {
   if(!knomi::ble_ready()){
     Serial.println("[MACRO] BLE not ready (not connected or not subscribed) — ignoring tap");
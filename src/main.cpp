@@ -11,7 +11,7 @@ void setup() {
 }
 
 void loop() {
-  lv_timer_handler();
+  // LVGL has its own task (see ui::begin); this one only polls network and web
   app_loop();
-  delay(0); // was 5
+  delay(10); // sleep between polls so core 1 can idle; HTTP latency stays under a frame
 }
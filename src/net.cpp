@@ -4,94 +4,288 @@
 #include <DNSServer.h>
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+extern "C" {
+  #include "esp_wifi.h"
+}
 
 namespace {
 const byte DNS_PORT = 53;
 DNSServer dnsServer;
 
 String g_ssid, g_pass;
+// last good association, reused to skip the scan on the next connect. The address
+// always comes from DHCP: a router that rebooted may have given ours away.
+struct StaCache {
+  uint8_t   bssid[6] = {};
+  int32_t   channel = 0;              // 0: nothing cached
+} g_cache;
+enum class Attempt : uint8_t { Fast, Scan };
+Attempt  g_attempt = Attempt::Scan;
+uint32_t g_retryAt = 0;
+uint32_t g_backoffMs = 0;
+bool     g_failNotified = false;      // onStaFailed once per outage
+std::atomic<uint8_t> g_discReason{0}; // set from the Wi-Fi event task
+constexpr uint32_t kFastTimeoutMs  = 5000;
+constexpr uint32_t kBackoffFirstMs = 5000;
+constexpr uint32_t kBackoffMaxMs   = 5 * 60 * 1000;
+String g_apSsid, g_apPass;
+net::Config g_cfg;
+uint32_t g_gotIpAt = 0;
 net::WifiCallbacks g_cb;
 uint32_t g_deadline = 0;
+uint32_t g_staTimeout = 0;
+bool g_suspended = false;
 net::StaState g_state = net::StaState::OFF;
 bool g_ap = false;
+std::atomic<bool> g_started{false};
+std::atomic<bool> g_requested{false};
+std::atomic<TaskHandle_t> g_waiter{nullptr};
+const char* kNetPath = "/config/net.json";
+const char* kStaPath = "/config/wifi.json";
 
 bool load_sta() {
-  if (!LittleFS.begin(true)) return false;
-  if (!LittleFS.exists("/config/wifi.json")) return false;
-  File f = LittleFS.open("/config/wifi.json", "r");
+  if (!LittleFS.exists(kStaPath)) return false;
+  File f = LittleFS.open(kStaPath, "r");
   if (!f) return false;
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<384> doc;
   if (deserializeJson(doc, f)) return false;
   g_ssid = String((const char*)doc["ssid"]);
   g_pass = String((const char*)doc["pass"]);
+  g_cache = StaCache();
+  const char* b = doc["bssid"] | "";
+  if (sscanf(b, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &g_cache.bssid[0], &g_cache.bssid[1],
+             &g_cache.bssid[2], &g_cache.bssid[3], &g_cache.bssid[4], &g_cache.bssid[5]) == 6)
+    g_cache.channel = doc["channel"] | 0;
   return g_ssid.length() > 0;
 }
 
-void start_ap(const char* ssid, const char* pass) {
-  WiFi.softAP(ssid, pass && strlen(pass)? pass : nullptr);
+// Credentials plus, when `c` has a channel, the association to reuse.
+bool write_sta(const String& ssid, const String& pass, const StaCache& c) {
+  LittleFS.mkdir("/config");
+  File f = LittleFS.open(kStaPath, "w");
+  if (!f) return false;
+  StaticJsonDocument<384> doc;
+  doc["ssid"] = ssid;
+  doc["pass"] = pass;
+  if (c.channel) {
+    char b[18];
+    snprintf(b, sizeof(b), "%02x:%02x:%02x:%02x:%02x:%02x",
+             c.bssid[0], c.bssid[1], c.bssid[2], c.bssid[3], c.bssid[4], c.bssid[5]);
+    doc["bssid"] = b;
+    doc["channel"] = c.channel;
+  }
+  serializeJson(doc, f);
+  return true;
+}
+
+// Called on GOT_IP; only touches flash when the association changed.
+void remember_sta() {
+  StaCache c;
+  if (const uint8_t* b = WiFi.BSSID()) memcpy(c.bssid, b, 6);
+  c.channel = WiFi.channel();
+  if (!memcmp(c.bssid, g_cache.bssid, 6) && c.channel == g_cache.channel) return;
+  g_cache = c;
+  write_sta(g_ssid, g_pass, g_cache);
+  Serial.printf("[NET] cached %s ch%d\n", WiFi.BSSIDstr().c_str(), (int)c.channel);
+}
+
+void start_ap() {
+  if (g_ap) return;
+  WiFi.mode(WIFI_AP_STA);
+  WiFi.softAP(g_apSsid.c_str(), g_apPass.length() ? g_apPass.c_str() : nullptr);
   dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
   g_ap = true;
+  Serial.println("[NET] AP + captive DNS up");
   if (g_cb.onApStarted) g_cb.onApStarted();
 }
 
+void stop_ap() {
+  if (!g_ap) return;
+  dnsServer.stop();
+  WiFi.softAPdisconnect(true);
+  WiFi.mode(WIFI_STA);
+  g_ap = false;
+  Serial.println("[NET] AP + captive DNS stopped (station up)");
+}
+
+void load_config() {
+  g_cfg = net::Config();
+  if (!LittleFS.exists(kNetPath)) return;
+  File f = LittleFS.open(kNetPath, "r");
+  if (!f) return;
+  StaticJsonDocument<128> doc;
+  if (deserializeJson(doc, f)) return;
+  g_cfg.start = strcmp(doc["start"] | "", "on_demand") == 0 ? net::Start::OnDemand : net::Start::Background;
+  g_cfg.ap_grace_s = doc["ap_grace_s"] | g_cfg.ap_grace_s;
+}
+
+// Fast: straight to the cached BSSID/channel, no scan. Scan: full scan, the fallback
+// when the fast path doesn't link in time. DHCP runs either way.
+void connect(Attempt a) {
+  g_attempt = a;
+  WiFi.disconnect();
+  if (a == Attempt::Fast) {
+    WiFi.begin(g_ssid.c_str(), g_pass.c_str(), g_cache.channel, g_cache.bssid);
+    g_deadline = millis() + kFastTimeoutMs;
+  } else {
+    WiFi.begin(g_ssid.c_str(), g_pass.c_str());
+    g_deadline = millis() + g_staTimeout;
+  }
+}
+
 void start_sta() {
   if (g_ssid.isEmpty()) return;
-  WiFi.begin(g_ssid.c_str(), g_pass.c_str());
+  g_discReason = 0;
+  connect(g_cache.channel ? Attempt::Fast : Attempt::Scan);
   g_state = net::StaState::CONNECTING;
   if (g_cb.onStaConnecting) g_cb.onStaConnecting();
 }
 
+void on_disconnected(arduino_event_id_t, arduino_event_info_t info) {
+  const uint8_t r = info.wifi_sta_disconnected.reason;
+  g_discReason = r ? r : 1;
+}
+
 } // anon
 
 namespace net {
 
 bool save_sta(const String& ssid, const String& pass) {
-  if (!LittleFS.begin(true)) return false;
-  LittleFS.mkdir("/config");
-  File f = LittleFS.open("/config/wifi.json", "w");
-  if (!f) return false;
-  StaticJsonDocument<256> doc;
-  doc["ssid"] = ssid;
-  doc["pass"] = pass;
-  serializeJson(doc, f);
-  return true;
+  g_cache = StaCache();   // new network: the old association means nothing
+  return write_sta(ssid, pass, g_cache);
 }
 
 bool clear_sta() {
-  if (!LittleFS.begin(true)) return false;
-  if (LittleFS.exists("/config/wifi.json")) LittleFS.remove("/config/wifi.json");
+  g_cache = StaCache();
+  if (LittleFS.exists(kStaPath)) LittleFS.remove(kStaPath);
   return true;
 }
 
 bool begin(const char* apSsid, const char* apPass, uint32_t staTimeoutMs,
            const WifiCallbacks& cb) {
   g_cb = cb;
-  WiFi.mode(WIFI_AP_STA);
-  start_ap(apSsid, apPass);
+  g_staTimeout = staTimeoutMs;
+  g_apSsid = apSsid;
+  g_apPass = apPass ? apPass : "";
+  config();   // ap_grace_s
+  start_ap();
+
+  // Retries are ours (backoff in loop()), not the driver's.
+  WiFi.setAutoReconnect(false);
+  WiFi.onEvent(on_disconnected, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
 
   // Load STA creds; try to connect if present.
-  if (load_sta()) {
-    start_sta();
-    g_deadline = millis() + staTimeoutMs;
-  }
+  if (load_sta()) start_sta();
   // Always start mDNS for knomipad.local
   MDNS.begin("knomipad");
+  g_started = true;
   return true;
 }
 
+bool started() { return g_started; }
+
+Config config() {
+  static bool loaded = false;
+  if (!loaded) { load_config(); loaded = true; }
+  return g_cfg;
+}
+
+bool configure(const Config& c) {
+  g_cfg = c;
+  LittleFS.mkdir("/config");
+  File f = LittleFS.open(kNetPath, "w");
+  if (!f) return false;
+  StaticJsonDocument<128> doc;
+  doc["start"] = start_name(c.start);
+  doc["ap_grace_s"] = c.ap_grace_s;
+  serializeJson(doc, f);
+  return true;
+}
+
+const char* start_name(Start s) { return s == Start::OnDemand ? "on_demand" : "background"; }
+
+void request_start() {
+  if (g_started || g_requested.exchange(true)) return;
+  Serial.println("[NET] Wi-Fi start requested");
+  if (TaskHandle_t t = g_waiter.load()) xTaskNotifyGive(t);
+}
+
+bool wait_for_start(uint32_t ms) {
+  g_waiter = xTaskGetCurrentTaskHandle();
+  if (!g_requested) ulTaskNotifyTake(pdTRUE, ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(ms));
+  g_waiter = nullptr;
+  return g_requested;
+}
+
+// The driver keeps mode and AP config across stop/start; STA has to reconnect.
+void suspend() {
+  if (!g_started || g_suspended) return;
+  esp_wifi_stop();
+  g_suspended = true;
+  if (g_state == StaState::CONNECTING || g_state == StaState::GOT_IP) g_state = StaState::OFF;
+}
+
+void resume() {
+  if (!g_suspended) return;
+  esp_wifi_start();
+  g_suspended = false;
+  start_sta();
+}
+
+bool suspended() { return g_suspended; }
+
 void loop() {
-  dnsServer.processNextRequest();
-
-  if (g_state == StaState::CONNECTING) {
-    if (WiFi.status() == WL_CONNECTED) {
-      g_state = StaState::GOT_IP;
-      if (g_cb.onStaGotIp) g_cb.onStaGotIp();
-      // keep AP for a short grace so clients don't drop; you can stop it later from app code if desired
-    } else if ((int32_t)(millis() - g_deadline) > 0) {
-      g_state = StaState::FAIL;
-      if (g_cb.onStaFailed) g_cb.onStaFailed();
-      // leave AP running for recovery
-    }
+  if (g_suspended) return;
+  if (g_ap) dnsServer.processNextRequest();
+
+  const bool linked = WiFi.status() == WL_CONNECTED;
+  const uint32_t now = millis();
+  switch (g_state) {
+    case StaState::CONNECTING:
+      if (linked) {
+        Serial.printf("[NET] station up (%s)\n", g_attempt == Attempt::Fast ? "cached AP" : "scan");
+        g_state = StaState::GOT_IP;
+        g_gotIpAt = now;
+        g_backoffMs = 0;
+        g_failNotified = false;
+        g_discReason = 0;
+        remember_sta();
+        if (g_cb.onStaGotIp) g_cb.onStaGotIp();
+      } else if ((int32_t)(now - g_deadline) > 0) {
+        if (g_attempt == Attempt::Fast) {
+          Serial.println("[NET] cached association failed, scanning");
+          connect(Attempt::Scan);
+          break;
+        }
+        g_backoffMs = g_backoffMs ? min(g_backoffMs * 2, kBackoffMaxMs) : kBackoffFirstMs;
+        g_retryAt = now + g_backoffMs;
+        g_state = StaState::FAIL;
+        WiFi.disconnect();
+        Serial.printf("[NET] station failed, retry in %us\n", (unsigned)(g_backoffMs / 1000));
+        start_ap();   // recovery path
+        if (!g_failNotified && g_cb.onStaFailed) g_cb.onStaFailed();
+        g_failNotified = true;
+      }
+      break;
+    case StaState::FAIL:
+      if ((int32_t)(now - g_retryAt) >= 0 && !g_ssid.isEmpty()) {
+        g_discReason = 0;
+        connect(g_cache.channel ? Attempt::Fast : Attempt::Scan);
+        g_state = StaState::CONNECTING;   // quiet retry: no onStaConnecting
+      }
+      break;
+    case StaState::GOT_IP:
+      if (!linked || g_discReason) {
+        Serial.printf("[NET] station link lost (reason %u)\n", (unsigned)g_discReason.load());
+        start_ap();
+        start_sta();
+        break;
+      }
+      // grace so clients on the AP can move over; never cut off one still attached
+      if (g_ap && g_cfg.ap_grace_s && millis() - g_gotIpAt >= g_cfg.ap_grace_s * 1000u &&
+          WiFi.softAPgetStationNum() == 0) stop_ap();
+      break;
+    default: break;
   }
 }
 
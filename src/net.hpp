@@ -1,29 +1,60 @@
 #pragma once
 #include <Arduino.h>
 #include <functional>
+#include <atomic>
 
 namespace net {
 
 enum class StaState { OFF, CONNECTING, GOT_IP, FAIL };
 
+// When Wi-Fi (AP, captive DNS, STA, mDNS, web) starts. It never blocks the
+// macropad path: the UI and BLE come up first either way.
+enum class Start : uint8_t {
+  Background,   // shortly after the UI and BLE are up
+  OnDemand,     // only when request_start() is called (long press on the clock page)
+};
+
 struct WifiCallbacks {
   std::function<void()> onApStarted;          // Captive portal up
   std::function<void()> onStaConnecting;      // Trying STA
   std::function<void()> onStaGotIp;           // STA OK
-  std::function<void()> onStaFailed;          // STA failed (timeout)
+  std::function<void()> onStaFailed;          // STA failed (timeout); once per outage, retries continue
 };
 
 bool begin(const char* apSsid, const char* apPass, uint32_t staTimeoutMs,
            const WifiCallbacks& cb);
+bool started();
+// Radio off without tearing anything down (coex.hpp), and back: AP as before, STA reconnects.
+void suspend();
+void resume();
+bool suspended();
+
+struct Config {
+  Start    start = Start::Background;   // read at boot
+  uint16_t ap_grace_s = 120;            // AP + captive DNS stay this long after GOT_IP; 0: keep them
+};
+Config config();                      // /config/net.json, defaults if unset
+bool configure(const Config& c);      // saved; the grace applies at once
+const char* start_name(Start s);
+void request_start();                 // any task; wakes wait_for_start()
+// Radio boot task: block until a request, or until `ms` has passed (UINT32_MAX: no timeout).
+// True if it was requested.
+bool wait_for_start(uint32_t ms);
 
 // periodic processing (DNS captive portal, HTTP, etc.)
 void loop();
 
+// STA connects to the cached BSSID/channel first, then falls back to a full scan; the
+// address always comes from DHCP.
+// After a failure it retries with exponential backoff (5 s doubling to 5 min) for as long
+// as it takes; a disconnect while up reconnects at once.
+// AP and captive DNS run while there is no station link: from begin() until GOT_IP plus
+// the grace (and no AP client left), and again as soon as the link drops or fails.
 StaState sta_state();
 bool sta_ok();
 bool ap_running();
 
-// Save/clear creds (LittleFS paths: /config/wifi.json)
+// Save/clear creds (LittleFS paths: /config/wifi.json; also holds the cached association)
 bool save_sta(const String& ssid, const String& pass);
 bool clear_sta();
 
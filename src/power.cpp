@@ -0,0 +1,194 @@
+#include "power.hpp"
+#include "lvgl_hal.h"
+#include "backlight.hpp"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include <mutex>
+extern "C" {
+  #include "esp_timer.h"
+}
+
+namespace {
+
+constexpr uint8_t  kSleepIn    = 0x10;    // GC9A01 SLPIN
+constexpr uint8_t  kSleepOut   = 0x11;    // GC9A01 SLPOUT
+constexpr uint32_t kSleepOutMs = 5;       // SLPOUT -> next command
+constexpr uint32_t kMaxCheckMs = 10000;   // longest check() period
+constexpr uint32_t kDimFadeMs  = 1000;
+constexpr uint32_t kOffFadeMs  = 400;
+constexpr uint32_t kWakeFadeMs = 120;     // from the first step on; the panel is lit right away
+constexpr uint32_t kFadePollMs = 50;      // while waiting for the off fade to finish
+const char* kPath = "/config/power.json";
+
+power::Config g_cfg;                    // written on the LVGL task only
+std::mutex    g_cfgMtx;                 // ...and read from others through config()
+power::Stats  g_stats{};
+power::State  g_state = power::State::Active;
+int64_t       g_lastInput = 0;
+lv_timer_t*   g_timer = nullptr;
+bool          g_panelAsleep = false;    // SLPIN sent; only once the off fade is done
+int64_t       g_sleepT0 = 0;
+void (*g_onDisplay)(bool) = nullptr;
+
+uint32_t since(int64_t t0){ return (uint32_t)(esp_timer_get_time() - t0); }
+
+// Fades run off the backlight driver's timer; these only start them.
+void dim(){
+  const int64_t t0 = esp_timer_get_time();
+  backlight::fade_to(g_cfg.dim_level, kDimFadeMs);
+  g_state = power::State::Dim;
+  g_stats.dims++;
+  g_stats.last_dim_us = since(t0);
+}
+
+// Rendering stops now; the panel goes to sleep from check() once the backlight is dark.
+void sleep(){
+  g_sleepT0 = esp_timer_get_time();
+  if(g_onDisplay) g_onDisplay(false);
+  backlight::fade_to(0, kOffFadeMs);
+  g_state = power::State::Off;
+  g_panelAsleep = false;
+  g_stats.sleeps++;
+}
+
+void panel_sleep(){
+  tft_gc9a01.writecommand(kSleepIn);
+  g_panelAsleep = true;
+  g_stats.last_sleep_us = since(g_sleepT0);
+}
+
+// The shadow framebuffer holds exactly what the panel showed when it went to sleep.
+void repaint(){
+  const lv_color_t* fb = lvgl_hal_framebuffer();
+  if(!fb) return;
+  tft_gc9a01.startWrite();
+  tft_gc9a01.setAddrWindow(0, 0, TFT_WIDTH, TFT_HEIGHT);
+  tft_gc9a01.pushColors((uint16_t*)fb, TFT_WIDTH * TFT_HEIGHT, true);
+  tft_gc9a01.endWrite();
+}
+
+// Next state change is due `idle` ms after the last input; check then (or sooner, for config edits).
+void check(lv_timer_t* t){
+  const uint32_t idle = since(g_lastInput) / 1000;
+  const uint32_t dimMs = g_cfg.dim_after_s * 1000u, offMs = g_cfg.off_after_s * 1000u;
+  if(g_state != power::State::Off && offMs && idle >= offMs) sleep();
+  else if(g_state == power::State::Active && dimMs && idle >= dimMs) dim();
+
+  if(g_state == power::State::Off){
+    if(backlight::fading()){ lv_timer_set_period(t, kFadePollMs); return; }
+    if(!g_panelAsleep) panel_sleep();
+    lv_timer_pause(t);   // wake() restarts it
+    return;
+  }
+  uint32_t next = kMaxCheckMs;
+  if(g_state == power::State::Active && dimMs && dimMs > idle) next = LV_MIN(next, dimMs - idle);
+  if(offMs && offMs > idle) next = LV_MIN(next, offMs - idle);
+  lv_timer_set_period(t, LV_MAX(next, 100u));
+}
+
+bool load(power::Config& c){
+  if(!LittleFS.exists(kPath)) return false;
+  File f = LittleFS.open(kPath, "r");
+  if(!f) return false;
+  StaticJsonDocument<128> doc;
+  if(deserializeJson(doc, f)) return false;
+  c.dim_after_s = doc["dim_s"] | c.dim_after_s;
+  c.off_after_s = doc["off_s"] | c.off_after_s;
+  c.level       = constrain((int)(doc["level"] | c.level), 1, 16);
+  c.dim_level   = constrain((int)(doc["dim_level"] | c.dim_level), 1, 16);
+  return true;
+}
+
+bool save(const power::Config& c){
+  LittleFS.mkdir("/config");
+  File f = LittleFS.open(kPath, "w");
+  if(!f) return false;
+  StaticJsonDocument<128> doc;
+  doc["dim_s"] = c.dim_after_s;
+  doc["off_s"] = c.off_after_s;
+  doc["level"] = c.level;
+  doc["dim_level"] = c.dim_level;
+  serializeJson(doc, f);
+  return true;
+}
+
+} // anon
+
+namespace power {
+
+void begin(void (*on_display)(bool on)){
+  g_onDisplay = on_display;
+  {
+    std::lock_guard<std::mutex> lk(g_cfgMtx);
+    load(g_cfg);
+  }
+  backlight::fade_to(g_cfg.level, kWakeFadeMs);
+  g_lastInput = esp_timer_get_time();
+  if(!g_timer) g_timer = lv_timer_create(check, kMaxCheckMs, nullptr);
+  Serial.printf("[PWR] dim after %us, off after %us\n", g_cfg.dim_after_s, g_cfg.off_after_s);
+}
+
+bool wake(uint32_t t_us){
+  g_lastInput = esp_timer_get_time();
+  if(g_state == State::Active) return false;
+  const bool wasOff = g_state == State::Off;
+  const int64_t t0 = esp_timer_get_time();
+  backlight::cancel();   // an off fade may still be running; the panel is awake then
+  if(wasOff && g_panelAsleep){
+    tft_gc9a01.writecommand(kSleepOut);
+    delay(kSleepOutMs);
+    repaint();
+    g_panelAsleep = false;
+  }
+  backlight::fade_to(g_cfg.level, kWakeFadeMs);
+  g_state = State::Active;
+  if(!wasOff) return false;
+
+  g_stats.wakes++;
+  g_stats.last_wake_us = since(t0);
+  if(t_us){
+    g_stats.last_latency_us = (uint32_t)esp_timer_get_time() - t_us;
+    if(g_stats.last_latency_us > g_stats.worst_latency_us) g_stats.worst_latency_us = g_stats.last_latency_us;
+  }
+  if(g_timer){ lv_timer_resume(g_timer); lv_timer_ready(g_timer); }
+  if(g_onDisplay) g_onDisplay(true);
+  return true;
+}
+
+bool display_off(){ return g_state == State::Off; }
+
+void configure(const Config& c){
+  Config n = c;
+  n.level = constrain(n.level, 1, 16);
+  n.dim_level = constrain(n.dim_level, 1, 16);
+  {
+    std::lock_guard<std::mutex> lk(g_cfgMtx);
+    g_cfg = n;
+  }
+  save(n);
+  // new brightness now, new timeouts from the next check
+  if(g_state == State::Active) backlight::fade_to(n.level, kWakeFadeMs);
+  else if(g_state == State::Dim) backlight::fade_to(n.dim_level, kWakeFadeMs);
+  if(g_timer && g_state != State::Off) lv_timer_ready(g_timer);
+}
+
+Config config(){
+  std::lock_guard<std::mutex> lk(g_cfgMtx);
+  return g_cfg;
+}
+
+Stats stats(){
+  Stats s = g_stats;
+  s.state = g_state;
+  return s;
+}
+
+const char* state_name(State s){
+  switch(s){
+    case State::Dim: return "dim";
+    case State::Off: return "off";
+    default:         return "active";
+  }
+}
+
+} // namespace power
@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+
+// Display power states. After a while without input the backlight fades down,
+// then out, and the GC9A01 enters sleep mode with LVGL rendering suspended. The
+// next touch wakes the panel, repaints the last frame from the shadow
+// framebuffer, fades the backlight back up and lets LVGL draw again. Fades run
+// in the background (backlight.hpp). Runs on the LVGL task.
+namespace power {
+
+enum class State : uint8_t { Active, Dim, Off };
+
+struct Config {
+  uint16_t dim_after_s = 60;    // 0: never dim
+  uint16_t off_after_s = 300;   // 0: never switch off (counted from the last input, not from dimming)
+  uint8_t  level       = 16;    // AW9346 steps, 1..16
+  uint8_t  dim_level   = 3;
+};
+
+struct Stats {
+  State    state;
+  uint32_t dims, sleeps, wakes;
+  uint32_t last_dim_us;         // time spent switching states, as last measured
+  uint32_t last_sleep_us;       // including the fade out
+  uint32_t last_wake_us;        // sleep-out + frame repaint + first backlight step
+  uint32_t last_latency_us;     // touch sample -> backlight on, for wakes from Off
+  uint32_t worst_latency_us;
+};
+
+// Load the saved config, light the panel and start the idle timer. `on_display`
+// is told when rendering stops (false) and may resume (true).
+void begin(void (*on_display)(bool on));
+// User input at `t_us` (esp_timer clock, 0 if unknown). Restores full brightness;
+// returns true if the panel had been off, i.e. this input only woke it.
+bool wake(uint32_t t_us);
+bool display_off();
+
+void configure(const Config& c);   // LVGL task (others: ui::set_power); saved to /config/power.json, applied at once
+Config config();                   // any task
+Stats stats();
+const char* state_name(State s);
+
+} // namespace power
@@ -0,0 +1,122 @@
+#include "render_stats.hpp"
+#include "lvgl_mem.h"
+extern "C" {
+  #include "esp_timer.h"
+}
+
+namespace {
+
+constexpr uint32_t kFrameBudgetUs = LV_DISP_DEF_REFR_PERIOD * 1000;
+
+render_stats::Stats g_stats{};
+render_stats::PageStats g_pages[render_stats::kMaxPages]{};
+uint16_t g_page = 0;
+int64_t  g_start = 0;
+uint32_t g_flushUs = 0;          // summed over the flushes of the current frame
+int64_t  g_secStart = 0;
+uint32_t g_secFrames = 0;
+
+lv_obj_t*   g_overlay = nullptr;
+lv_timer_t* g_overlayTimer = nullptr;
+
+size_t time_bucket(uint32_t us){
+  size_t b = 0;
+  while(b < render_stats::kTimeBuckets - 1 && us >= render_stats::kTimeEdgesUs[b]) ++b;
+  return b;
+}
+
+size_t area_bucket(uint32_t px){
+  const uint32_t full = (uint32_t)lv_disp_get_hor_res(nullptr) * lv_disp_get_ver_res(nullptr);
+  if(px >= full) return 5;
+  const uint32_t pct = px * 100 / full;
+  if(pct < 1)  return 0;
+  if(pct < 10) return 1;
+  if(pct < 25) return 2;
+  if(pct < 50) return 3;
+  return 4;
+}
+
+void overlay_update(lv_timer_t*){
+  if(!g_overlay) return;
+  lv_label_set_text_fmt(g_overlay, "%lu fps  r %lu.%lu  f %lu.%lu ms",
+    (unsigned long)g_stats.fps,
+    (unsigned long)(g_stats.last_render_us / 1000), (unsigned long)(g_stats.last_render_us % 1000 / 100),
+    (unsigned long)(g_stats.last_flush_us / 1000),  (unsigned long)(g_stats.last_flush_us % 1000 / 100));
+}
+
+} // anon
+
+namespace render_stats {
+
+const uint32_t kTimeEdgesUs[kTimeBuckets - 1] = { 2000, 4000, 8000, 16667, 33333, 66667 };
+
+void on_render_start(){
+  if(g_start) return;   // LVGL calls this per area; the frame started at the first
+  g_start = esp_timer_get_time();
+  g_flushUs = 0;
+}
+
+void on_flush(uint32_t us){ g_flushUs += us; }
+
+void on_frame_done(uint32_t px){
+  if(!g_start) return;
+  const int64_t now = esp_timer_get_time();
+  const uint32_t total = (uint32_t)(now - g_start);
+  const uint32_t render = total > g_flushUs ? total - g_flushUs : 0;
+  g_start = 0;
+
+  g_stats.frames++;
+  g_stats.last_render_us = render;
+  g_stats.last_flush_us = g_flushUs;
+  g_stats.last_px = px;
+  g_stats.render_hist[time_bucket(render)]++;
+  g_stats.flush_hist[time_bucket(g_flushUs)]++;
+  g_stats.frame_hist[time_bucket(total)]++;
+  g_stats.area_hist[area_bucket(px)]++;
+
+  g_secFrames++;
+  if(now - g_secStart >= 1000000){
+    g_stats.fps = g_secFrames;
+    g_secFrames = 0;
+    g_secStart = now;
+  }
+
+  PageStats& p = g_pages[g_page < kMaxPages ? g_page : kMaxPages - 1];
+  p.frames++;
+  if(total > kFrameBudgetUs) p.over_budget++;
+  if(total > p.worst_us) p.worst_us = total;
+  const lvgl_mem_stats_t mem = lvgl_mem_stats();
+  const uint32_t used = mem.small_bytes + mem.large_bytes;
+  if(used > p.heap_peak) p.heap_peak = used;
+}
+
+void set_page(uint16_t page){ g_page = page; }
+
+void set_overlay(bool on){
+  if(on == (g_overlay != nullptr)) return;
+  if(on){
+    g_overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_text_color(g_overlay, lv_color_white(), 0);
+    lv_obj_set_style_bg_color(g_overlay, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(g_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_pad_hor(g_overlay, 6, 0);
+    lv_obj_align(g_overlay, LV_ALIGN_BOTTOM_MID, 0, -28);   // inside the round panel
+    g_overlayTimer = lv_timer_create(overlay_update, 500, nullptr);
+    overlay_update(nullptr);
+  }else{
+    lv_timer_del(g_overlayTimer); g_overlayTimer = nullptr;
+    lv_obj_del(g_overlay); g_overlay = nullptr;
+  }
+}
+
+bool overlay(){ return g_overlay != nullptr; }
+
+Stats stats(){ return g_stats; }
+
+size_t page_stats(PageStats* out, size_t max){
+  size_t n = max < kMaxPages ? max : kMaxPages;
+  for(size_t i = 0; i < n; ++i) out[i] = g_pages[i];
+  return n;
+}
+
+} // namespace render_stats
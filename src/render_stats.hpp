@@ -0,0 +1,48 @@
+#pragma once
+#include <lvgl.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Always-on render instrumentation. The display driver reports when a refresh
+// starts, how long each flush takes and when the frame is done; everything is
+// binned into fixed histograms so the cost per frame is a handful of adds.
+// Per-page peaks show which page blows the frame budget.
+namespace render_stats {
+
+constexpr size_t kTimeBuckets = 7;   // <2, <4, <8, <16.7, <33, <66, >=66 ms
+constexpr size_t kAreaBuckets = 6;   // <1%, <10%, <25%, <50%, <100%, full screen
+constexpr size_t kMaxPages    = 32;  // pages past this share the last entry
+extern const uint32_t kTimeEdgesUs[kTimeBuckets - 1];
+
+struct PageStats {
+  uint32_t frames;
+  uint32_t over_budget;   // frames longer than one refresh period
+  uint32_t worst_us;
+  uint32_t heap_peak;     // most LVGL heap (both tiers, lvgl_mem.h) in use while the page was up
+};
+
+struct Stats {
+  uint32_t frames;
+  uint32_t fps;                   // frames in the last full second
+  uint32_t last_render_us;        // draw time, flush excluded
+  uint32_t last_flush_us;
+  uint32_t last_px;
+  uint32_t render_hist[kTimeBuckets];
+  uint32_t flush_hist[kTimeBuckets];
+  uint32_t frame_hist[kTimeBuckets];   // render + flush
+  uint32_t area_hist[kAreaBuckets];
+};
+
+// Display driver hooks (lvgl_hal)
+void on_render_start();             // may repeat within a frame
+void on_flush(uint32_t us);
+void on_frame_done(uint32_t px);
+
+void set_page(uint16_t page);       // LVGL task; attributes following frames to `page`
+void set_overlay(bool on);          // LVGL task
+bool overlay();
+
+Stats stats();
+size_t page_stats(PageStats* out, size_t max);
+
+} // namespace render_stats
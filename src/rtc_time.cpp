@@ -27,10 +27,13 @@ void rtime::set_from_epoch_ms(uint64_t ms, int tz_offset_min) {
   g_tz_min = tz_offset_min;
 }
 
-void rtime::format(char* out, size_t n, const char* timeFmt, const char* dateFmt) {
-  time_t t = time(nullptr);
+time_t rtime::local_now() {
   // Apply browser-provided offset without messing with global TZ
-  t += g_tz_min * 60;
+  return time(nullptr) + g_tz_min * 60;
+}
+
+void rtime::format(char* out, size_t n, const char* timeFmt, const char* dateFmt) {
+  time_t t = local_now();
   struct tm tm; gmtime_r(&t, &tm);
   char tbuf[32], dbuf[48];
   strftime(tbuf, sizeof(tbuf), timeFmt, &tm);
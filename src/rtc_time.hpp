@@ -5,5 +5,6 @@ namespace rtime {
   void loop();                        // no-op
   bool valid();                       // true if time is set
   void set_from_epoch_ms(uint64_t ms, int tz_offset_min); // host sync
+  time_t local_now();                 // epoch seconds shifted by the host's UTC offset (read with gmtime_r)
   void format(char* out, size_t n, const char* timeFmt, const char* dateFmt);
 }
@@ -0,0 +1,198 @@
+#include "splash.hpp"
+#include "lvgl_hal.h"
+#include "power.hpp"
+#include "transition.hpp"
+#include <LittleFS.h>
+extern "C" {
+  #include "esp_timer.h"
+}
+
+namespace {
+
+constexpr uint32_t kMagic        = 0x4C50534B;   // "KSPL"
+constexpr uint16_t kVersion      = 1;
+constexpr uint32_t kCheckMs      = 30000;        // while dimmed
+constexpr uint32_t kMinIntervalMs = 10 * 60 * 1000;   // flash wear: at most six writes an hour
+constexpr uint32_t kOffIntervalMs = 60 * 1000;        // the frame before the panel goes dark matters more
+constexpr size_t   kIoBytes      = 512;
+constexpr int      kPixels       = TFT_WIDTH * TFT_HEIGHT;
+const char* kPath = "/config/splash.rle";
+const char* kTmp  = "/config/splash.tmp";
+
+struct Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t w, h;
+  uint16_t reserved;
+  uint32_t bytes;          // coded payload after the header
+};
+
+splash::Stats g_stats{};
+uint32_t g_savedHash = 0;
+int64_t  g_lastSave = 0;   // esp_timer us, 0: never this boot
+lv_timer_t* g_timer = nullptr;
+
+uint32_t since_ms(int64_t t0){ return (uint32_t)((esp_timer_get_time() - t0) / 1000); }
+
+uint32_t hash(const lv_color_t* fb){
+  const uint32_t* w = (const uint32_t*)fb;
+  uint32_t h = 2166136261u;
+  for(int i = 0; i < kPixels / 2; ++i) h = (h ^ w[i]) * 16777619u;
+  return h;
+}
+
+// PackBits over pixels: a control byte c < 128 is followed by c+1 literal pixels,
+// c >= 128 by one pixel repeated c-126 times (2..129).
+struct Writer {
+  File& f;
+  uint8_t buf[kIoBytes];
+  size_t n = 0;
+  uint32_t total = 0;
+  bool ok = true;
+  explicit Writer(File& file): f(file) {}
+  void put(const void* p, size_t len){
+    const uint8_t* b = (const uint8_t*)p;
+    while(len){
+      const size_t k = LV_MIN(len, sizeof(buf) - n);
+      memcpy(buf + n, b, k);
+      n += k; b += k; len -= k; total += k;
+      if(n == sizeof(buf)) drain();
+    }
+  }
+  void drain(){
+    if(n && f.write(buf, n) != n) ok = false;
+    n = 0;
+  }
+};
+
+void encode(const lv_color_t* px, Writer& w){
+  int i = 0;
+  while(i < kPixels){
+    int run = 1;
+    while(i + run < kPixels && run < 129 && px[i + run].full == px[i].full) ++run;
+    if(run >= 2){
+      const uint8_t c = (uint8_t)(run + 126);
+      w.put(&c, 1);
+      w.put(&px[i], sizeof(lv_color_t));
+      i += run;
+      continue;
+    }
+    int lit = 1;   // up to the next pair of equal pixels
+    while(i + lit < kPixels && lit < 128 && !(i + lit + 1 < kPixels && px[i + lit].full == px[i + lit + 1].full)) ++lit;
+    const uint8_t c = (uint8_t)(lit - 1);
+    w.put(&c, 1);
+    w.put(&px[i], lit * sizeof(lv_color_t));
+    i += lit;
+  }
+}
+
+struct Reader {
+  File& f;
+  uint8_t buf[kIoBytes];
+  size_t n = 0, pos = 0;
+  explicit Reader(File& file): f(file) {}
+  bool get(void* p, size_t len){
+    uint8_t* b = (uint8_t*)p;
+    while(len){
+      if(pos == n){
+        n = f.read(buf, sizeof(buf));
+        pos = 0;
+        if(!n) return false;
+      }
+      const size_t k = LV_MIN(len, n - pos);
+      memcpy(b, buf + pos, k);
+      pos += k; b += k; len -= k;
+    }
+    return true;
+  }
+};
+
+bool decode(File& f, lv_color_t* px){
+  Reader r(f);
+  int i = 0;
+  while(i < kPixels){
+    uint8_t c;
+    if(!r.get(&c, 1)) return false;
+    if(c < 128){
+      const int lit = c + 1;
+      if(i + lit > kPixels || !r.get(&px[i], lit * sizeof(lv_color_t))) return false;
+      i += lit;
+    }else{
+      const int run = c - 126;
+      lv_color_t v;
+      if(i + run > kPixels || !r.get(&v, sizeof(v))) return false;
+      for(int k = 0; k < run; ++k) px[i + k] = v;
+      i += run;
+    }
+  }
+  return true;
+}
+
+bool save(uint32_t minIntervalMs){
+  const lv_color_t* fb = lvgl_hal_framebuffer();
+  if(!fb || transition::active()) return false;
+  const uint32_t h = hash(fb);
+  if(h == g_savedHash || (g_lastSave && since_ms(g_lastSave) < minIntervalMs)){
+    g_stats.skipped++;
+    return false;
+  }
+  const int64_t t0 = esp_timer_get_time();
+  LittleFS.mkdir("/config");
+  File f = LittleFS.open(kTmp, "w");
+  if(!f) return false;
+  Header hdr{kMagic, kVersion, TFT_WIDTH, TFT_HEIGHT, 0, 0};
+  f.write((const uint8_t*)&hdr, sizeof(hdr));
+  Writer w(f);
+  encode(fb, w);
+  w.drain();
+  hdr.bytes = w.total;
+  const bool ok = w.ok && f.seek(0) && f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+  f.close();
+  if(!ok || !LittleFS.rename(kTmp, kPath)){
+    LittleFS.remove(kTmp);
+    return false;
+  }
+  g_savedHash = h;
+  g_lastSave = esp_timer_get_time();
+  g_stats.saves++;
+  g_stats.last_bytes = sizeof(hdr) + w.total;
+  g_stats.last_save_ms = since_ms(t0);
+  Serial.printf("[SPLASH] saved %u bytes in %u ms\n", g_stats.last_bytes, g_stats.last_save_ms);
+  return true;
+}
+
+} // anon
+
+namespace splash {
+
+bool show(lv_color_t* fb){
+  if(!fb) return false;
+  const int64_t t0 = esp_timer_get_time();
+  if(!LittleFS.begin(false)) return false;   // app_begin formats a broken filesystem later
+  File f = LittleFS.open(kPath, "r");
+  if(!f) return false;
+  Header hdr;
+  if(f.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != kMagic || hdr.version != kVersion ||
+     hdr.w != TFT_WIDTH || hdr.h != TFT_HEIGHT || hdr.bytes != f.size() - sizeof(hdr)) return false;
+  if(!decode(f, fb)) return false;
+  tft_gc9a01.startWrite();
+  tft_gc9a01.setAddrWindow(0, 0, TFT_WIDTH, TFT_HEIGHT);
+  tft_gc9a01.pushColors((uint16_t*)fb, kPixels, true);
+  tft_gc9a01.endWrite();
+  g_savedHash = hash(fb);   // nothing to write until the UI shows something else
+  g_stats.boot_show_ms = since_ms(t0);
+  return true;
+}
+
+void begin(){
+  if(g_timer) return;
+  g_timer = lv_timer_create([](lv_timer_t*){
+    if(power::stats().state == power::State::Dim) save(kMinIntervalMs);
+  }, kCheckMs, nullptr);
+}
+
+void save_idle(){ save(kOffIntervalMs); }
+
+Stats stats(){ return g_stats; }
+
+} // namespace splash
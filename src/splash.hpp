@@ -0,0 +1,27 @@
+#pragma once
+#include <lvgl.h>
+
+// Boot splash: the last page the panel showed, run-length coded in
+// /config/splash.rle. show() puts it on the GC9A01 right after tft.begin(),
+// before LVGL or the radios start, so boot looks instant. Frames are saved
+// from the shadow framebuffer only while the user is idle (dimmed, or as the
+// panel switches off), at most every few minutes and only when they changed.
+namespace splash {
+
+// Decode the saved frame into `fb` (TFT_WIDTH x TFT_HEIGHT) and push it to the
+// panel. False when there is none or it doesn't check out; fb is not valid then.
+bool show(lv_color_t* fb);
+
+void begin();        // LVGL task: start the idle-time save check
+void save_idle();    // LVGL task: the panel is about to go dark, keep what it shows
+
+struct Stats {
+  uint32_t saves;          // frames written this boot
+  uint32_t skipped;        // save chances passed up: unchanged or throttled
+  uint32_t last_bytes;     // file size of the last save
+  uint32_t last_save_ms;   // encode + write
+  uint32_t boot_show_ms;   // read + decode + push at boot, 0 if there was no splash
+};
+Stats stats();
+
+} // namespace splash
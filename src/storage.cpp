@@ -1,10 +1,34 @@
 #include "storage.hpp"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+extern "C" {
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/semphr.h"
+}
 
 namespace storage {
 
 static Profile g_prof;
+static uint32_t g_nextHandle = 1;
+static uint32_t g_rev = 1;
+static std::function<void(uint32_t)> g_onChange;
+
+static void stamp(macros::Slot& s) {
+  if (!s.handle) s.handle = g_nextHandle++;
+  s.rev = ++g_rev;
+}
+
+// Writers (web handlers) and the LVGL task's readers meet here. Listeners
+// run after the lock is released.
+static SemaphoreHandle_t g_mtx = nullptr;
+struct Lock {
+  Lock()  { if (!g_mtx) g_mtx = xSemaphoreCreateRecursiveMutex(); xSemaphoreTakeRecursive(g_mtx, portMAX_DELAY); }
+  ~Lock() { xSemaphoreGiveRecursive(g_mtx); }
+};
+
+static void notify() {
+  if (g_onChange) g_onChange(g_rev);
+}
 
 static void ensure_defaults(Profile& p) {
   if (!p.slots.empty()) return;
@@ -26,10 +50,61 @@ static void ensure_defaults(Profile& p) {
   }
 }
 
-bool begin() {
-  return LittleFS.begin(true);
+void binding_from_json(JsonObjectConst b, macros::Binding& out) {
+  if (b.isNull()) { out = macros::Binding(); return; }
+  out.type = macros::type_from_string(String((const char*)(b["type"] | "keybind")));
+  out.payload = String((const char*)b["payload"]);
+}
+
+void binding_to_json(const macros::Binding& b, JsonObject parent, const char* key) {
+  if (!b.set()) return;
+  JsonObject o = parent.createNestedObject(key);
+  o["type"] = macros::type_to_string(b.type);
+  o["payload"] = b.payload;
 }
 
+void slot_from_json(JsonObjectConst s, macros::Slot& slot) {
+  slot.id = s["id"] | 0;
+  slot.title = String((const char*)s["title"]);
+  slot.payload = String((const char*)s["payload"]);
+  slot.iconPath = String((const char*)s["iconPath"]);
+  slot.bg = s["bg"] | 0x2D9BF0;
+  slot.bg2 = s["bg2"] | slot.bg;
+  slot.gradient = s["gradient"] | false;
+  slot.trigger = macros::trigger_from_string(String((const char*)(s["trigger"] | "release")));
+  binding_from_json(s["double"].as<JsonObjectConst>(), slot.doubleTap);
+  binding_from_json(s["long"].as<JsonObjectConst>(), slot.longPress);
+  slot.doubleTapMs = s["doubleMs"] | 250;
+  String t = String((const char*)s["type"]);
+  t.toLowerCase();
+  if (t=="keystroke") slot.type = macros::Type::Keystroke;
+  else if (t=="typing") slot.type = macros::Type::Typing;
+  else if (t=="holdseq") slot.type = macros::Type::HoldSeq;
+  else slot.type = macros::Type::Keybind;
+}
+
+void slot_to_json(const macros::Slot& s, JsonObject o) {
+  o["id"] = s.id;
+  o["title"] = s.title;
+  o["payload"] = s.payload;
+  o["iconPath"] = s.iconPath;
+  o["bg"] = s.bg;
+  o["bg2"] = s.bg2;
+  o["gradient"] = s.gradient;
+  o["trigger"] = macros::trigger_to_string(s.trigger);
+  binding_to_json(s.doubleTap, o, "double");
+  binding_to_json(s.longPress, o, "long");
+  if (s.doubleTap.set()) o["doubleMs"] = s.doubleTapMs;
+  switch (s.type) {
+    case macros::Type::Keystroke: o["type"]="keystroke"; break;
+    case macros::Type::Typing:    o["type"]="typing"; break;
+    case macros::Type::HoldSeq:   o["type"]="holdseq"; break;
+    default:                      o["type"]="keybind"; break;
+  }
+}
+
+// The slots array is streamed one element at a time, so the profile size is
+// bounded by flash rather than by a JSON document.
 bool load(Profile& out) {
   if (!begin()) return false;
   if (!LittleFS.exists("/macros/slots.json")) {
@@ -39,27 +114,15 @@ bool load(Profile& out) {
   }
   File f = LittleFS.open("/macros/slots.json", "r");
   if (!f) { ensure_defaults(out); return false; }
-  StaticJsonDocument<2048> doc;
-  auto err = deserializeJson(doc, f);
-  if (err) { ensure_defaults(out); return false; }
+  if (!f.find("\"slots\"") || !f.find("[")) { ensure_defaults(out); return false; }
   out.slots.clear();
-  for (JsonObject s : doc["slots"].as<JsonArray>()) {
+  StaticJsonDocument<1536> doc;
+  do {
+    if (deserializeJson(doc, f)) break;
     macros::Slot slot;
-    slot.id = s["id"] | 0;
-    slot.title = String((const char*)s["title"]);
-    slot.payload = String((const char*)s["payload"]);
-    slot.iconPath = String((const char*)s["iconPath"]);
-    slot.bg = s["bg"] | 0x2D9BF0;
-    slot.bg2 = s["bg2"] | slot.bg;
-    slot.gradient = s["gradient"] | false;
-    String t = String((const char*)s["type"]);
-    t.toLowerCase();
-    if (t=="keystroke") slot.type = macros::Type::Keystroke;
-    else if (t=="typing") slot.type = macros::Type::Typing;
-    else if (t=="holdseq") slot.type = macros::Type::HoldSeq;
-    else slot.type = macros::Type::Keybind;
+    slot_from_json(doc.as<JsonObjectConst>(), slot);
     out.slots.push_back(slot);
-  }
+  } while (f.findUntil(",", "]"));
   if (out.slots.empty()) ensure_defaults(out);
   return true;
 }
@@ -69,42 +132,98 @@ bool save(const Profile& in) {
   LittleFS.mkdir("/macros");
   File f = LittleFS.open("/macros/slots.json", "w");
   if (!f) return false;
-  StaticJsonDocument<2048> doc;
-  JsonArray arr = doc.createNestedArray("slots");
-  for (auto& s : in.slots) {
-    JsonObject o = arr.createNestedObject();
-    o["id"] = s.id;
-    o["title"] = s.title;
-    o["payload"] = s.payload;
-    o["iconPath"] = s.iconPath;
-    o["bg"] = s.bg;
-    o["bg2"] = s.bg2;
-    o["gradient"] = s.gradient;
-    switch (s.type) {
-      case macros::Type::Keystroke: o["type"]="keystroke"; break;
-      case macros::Type::Typing:    o["type"]="typing"; break;
-      case macros::Type::HoldSeq:   o["type"]="holdseq"; break;
-      default:                      o["type"]="keybind"; break;
-    }
+  StaticJsonDocument<1536> doc;
+  f.print("{\"slots\":[");
+  for (size_t i = 0; i < in.slots.size(); ++i) {
+    doc.clear();
+    slot_to_json(in.slots[i], doc.to<JsonObject>());
+    if (i) f.print(',');
+    serializeJson(doc, f);
   }
-  serializeJson(doc, f);
+  f.print("]}");
   return true;
 }
 
 Profile& profile() { return g_prof; }
-bool load() { return load(g_prof); }
+bool load() {
+  Profile p;
+  bool ok = load(p);
+  replace(std::move(p));
+  return ok;
+}
 bool save() { return save(g_prof); }
 
-macros::Slot* get_slot(uint8_t id) {
+macros::Slot* get_slot(uint16_t id) {
   if (id >= g_prof.slots.size()) return nullptr;
   return &g_prof.slots[id];
 }
-bool set_slot(uint8_t id, const macros::Slot& s) {
-  if (id >= g_prof.slots.size()) g_prof.slots.resize(id+1);
-  g_prof.slots[id] = s;
-  g_prof.slots[id].id = id;
+bool set_slot(uint16_t id, const macros::Slot& s) {
+  {
+    Lock lk;
+    if (id > g_prof.slots.size()) return false;   // no gaps: edit a slot or append one
+    if (id == g_prof.slots.size()) g_prof.slots.emplace_back();
+    uint32_t handle = g_prof.slots[id].handle;
+    g_prof.slots[id] = s;
+    g_prof.slots[id].id = id;
+    g_prof.slots[id].handle = handle;
+    stamp(g_prof.slots[id]);
+    ++g_rev;
+  }
+  notify();
+  return true;
+}
+uint16_t count() { Lock lk; return g_prof.slots.size(); }
+
+uint16_t add_slot(const macros::Slot& s) {
+  uint16_t idx;
+  {
+    Lock lk;
+    g_prof.slots.push_back(s);
+    g_prof.slots.back().handle = 0;
+    stamp(g_prof.slots.back());
+    ++g_rev;
+    idx = g_prof.slots.size() - 1;
+  }
+  notify();
+  return idx;
+}
+
+bool remove_slot(uint16_t index) {
+  {
+    Lock lk;
+    if (index >= g_prof.slots.size()) return false;
+    g_prof.slots.erase(g_prof.slots.begin() + index);
+    ++g_rev;
+  }
+  notify();
+  return true;
+}
+
+void replace(Profile&& p) {
+  {
+    Lock lk;
+    g_prof = std::move(p);
+    for (auto& s : g_prof.slots) { s.handle = 0; stamp(s); }
+    ++g_rev;
+  }
+  notify();
+}
+
+bool read_slot(uint16_t index, macros::Slot& out) {
+  Lock lk;
+  if (index >= g_prof.slots.size()) return false;
+  out = g_prof.slots[index];
   return true;
 }
-uint8_t count() { return g_prof.slots.size(); }
+
+int32_t index_of(uint32_t handle) {
+  Lock lk;
+  for (size_t i = 0; i < g_prof.slots.size(); ++i)
+    if (g_prof.slots[i].handle == handle) return (int32_t)i;
+  return -1;
+}
+
+uint32_t revision() { Lock lk; return g_rev; }
+void on_change(std::function<void(uint32_t)> cb) { g_onChange = cb; }
 
 } // namespace storage
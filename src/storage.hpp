@@ -1,6 +1,8 @@
 #pragma once
 #include <Arduino.h>
 #include <vector>
+#include <functional>
+#include <ArduinoJson.h>
 #include "macros.hpp"
 
 namespace storage {
@@ -9,7 +11,7 @@ struct Profile {
   std::vector<macros::Slot> slots;
 };
 
-bool begin();             // Mount FS
+// LittleFS is mounted once by the boot sequencer (boot.hpp) before any of these run
 bool load(Profile& out);  // Load from /macros/slots.json (create defaults if missing)
 bool save(const Profile& in);
 
@@ -18,8 +20,26 @@ bool load();              // loads into global
 bool save();              // saves global
 
 // Helpers
-macros::Slot* get_slot(uint8_t id);
-bool set_slot(uint8_t id, const macros::Slot& s);
-uint8_t count();
+macros::Slot* get_slot(uint16_t id);
+bool set_slot(uint16_t id, const macros::Slot& s);   // keeps the slot's handle, bumps its rev; id == count() appends, beyond fails
+uint16_t count();
+
+// Revisioned edits. Every change bumps revision() and calls the change listener,
+// so the UI can diff its pages instead of holding pointers into the slot vector.
+// Edits and the copy/lookup calls below are serialized by a mutex; profile() and
+// get_slot() are for the task that makes the edits (the web server).
+uint16_t add_slot(const macros::Slot& s);   // append with a fresh handle, returns index
+bool remove_slot(uint16_t index);
+void replace(Profile&& p);                  // whole profile (import)
+bool read_slot(uint16_t index, macros::Slot& out);   // copy, safe to keep
+int32_t index_of(uint32_t handle);          // -1 if the slot is gone
+uint32_t revision();
+void on_change(std::function<void(uint32_t rev)> cb);
+
+// JSON <-> Slot, shared by the profile file and the web API
+void slot_from_json(JsonObjectConst o, macros::Slot& out);
+void binding_from_json(JsonObjectConst o, macros::Binding& out);   // null object clears it
+void binding_to_json(const macros::Binding& b, JsonObject parent, const char* key);  // skipped when unset
+void slot_to_json(const macros::Slot& s, JsonObject o);
 
 } // namespace storage
@@ -0,0 +1,126 @@
+#include "style_pool.hpp"
+#include <vector>
+
+namespace {
+
+enum class Kind : uint8_t { Page, ClockPage, ClockLabel, TapDot };
+
+struct Entry {
+  lv_style_t style;
+  Kind     kind;
+  uint32_t bg, bg2;
+  bool     painted;
+  uint16_t refs;
+};
+
+std::vector<Entry*> g_entries;   // entries are heap nodes: objects point at their lv_style_t
+style_pool::Stats g_stats{};     // kept current on attach/detach; read from the web task
+
+lv_color_t rgb(uint32_t c){ return lv_color_make((c >> 16) & 255, (c >> 8) & 255, c & 255); }
+
+// What the same properties cost as one object's local style.
+uint32_t local_bytes(const lv_style_t& s){
+  return sizeof(lv_style_t) + s.prop_cnt * (sizeof(lv_style_value_t) + sizeof(lv_style_prop_t));
+}
+
+Entry* find(lv_style_t* s){
+  for(auto e : g_entries) if(&e->style == s) return e;
+  return nullptr;
+}
+
+Entry* make(Kind k){
+  Entry* e = new Entry{};
+  e->kind = k;
+  lv_style_init(&e->style);
+  g_entries.push_back(e);
+  return e;
+}
+
+// Fixed looks are built on first use and live for good.
+Entry* fixed(Kind k){
+  for(auto e : g_entries) if(e->kind == k) return e;
+  Entry* e = make(k);
+  lv_style_t* s = &e->style;
+  switch(k){
+    case Kind::ClockPage:
+      lv_style_set_bg_color(s, lv_color_black());
+      lv_style_set_bg_opa(s, LV_OPA_COVER);
+      lv_style_set_pad_all(s, 0);
+      lv_style_set_border_width(s, 0);
+      break;
+    case Kind::ClockLabel:
+      lv_style_set_text_color(s, lv_color_white());
+#if LV_FONT_MONTSERRAT_22
+      lv_style_set_text_font(s, &lv_font_montserrat_22);
+#endif
+      break;
+    case Kind::TapDot:
+      lv_style_set_radius(s, LV_RADIUS_CIRCLE);
+      lv_style_set_bg_color(s, lv_color_white());
+      lv_style_set_bg_opa(s, LV_OPA_COVER);
+      lv_style_set_border_width(s, 0);
+      break;
+    default: break;
+  }
+  return e;
+}
+
+} // anon
+
+namespace style_pool {
+
+lv_style_t* page(uint32_t bg, uint32_t bg2, bool painted){
+  for(auto e : g_entries)
+    if(e->kind == Kind::Page && e->bg == bg && e->bg2 == bg2 && e->painted == painted) return &e->style;
+
+  Entry* e = make(Kind::Page);
+  e->bg = bg; e->bg2 = bg2; e->painted = painted;
+  lv_style_t* s = &e->style;
+  lv_style_set_pad_all(s, 0);
+  lv_style_set_border_width(s, 0);
+  lv_style_set_radius(s, 0);   // the round panel hides the corners; square fills need no mask
+  lv_style_set_bg_color(s, rgb(bg));
+  if(painted){
+    lv_style_set_bg_opa(s, LV_OPA_TRANSP);
+    lv_style_set_bg_grad_dir(s, LV_GRAD_DIR_NONE);
+  }else if(bg2 != bg){
+    lv_style_set_bg_opa(s, LV_OPA_COVER);
+    lv_style_set_bg_grad_dir(s, LV_GRAD_DIR_VER);
+    lv_style_set_bg_grad_color(s, rgb(bg2));
+  }else{
+    lv_style_set_bg_opa(s, LV_OPA_COVER);
+    lv_style_set_bg_grad_dir(s, LV_GRAD_DIR_NONE);
+  }
+  return s;
+}
+
+lv_style_t* clock_page(){ return &fixed(Kind::ClockPage)->style; }
+lv_style_t* clock_label(){ return &fixed(Kind::ClockLabel)->style; }
+lv_style_t* tap_dot(){ return &fixed(Kind::TapDot)->style; }
+
+void attach(lv_obj_t* obj, lv_style_t* s){
+  Entry* e = find(s);
+  if(!e) return;
+  lv_obj_add_style(obj, s, 0);
+  if(e->refs++) g_stats.bytes_saved += local_bytes(e->style);
+  else g_stats.styles++;
+  g_stats.attached++;
+}
+
+void detach(lv_obj_t* obj, lv_style_t* s){
+  Entry* e = find(s);
+  if(!e) return;
+  lv_obj_remove_style(obj, s, 0);
+  if(!e->refs) return;
+  g_stats.attached--;
+  if(--e->refs) g_stats.bytes_saved -= local_bytes(e->style);
+  else g_stats.styles--;
+  if(e->refs || e->kind != Kind::Page) return;
+  for(size_t i = 0; i < g_entries.size(); ++i) if(g_entries[i] == e){ g_entries.erase(g_entries.begin() + i); break; }
+  lv_style_reset(&e->style);
+  delete e;
+}
+
+Stats stats(){ return g_stats; }
+
+} // namespace style_pool
@@ -0,0 +1,29 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+
+// Shared lv_style_t objects for the page widgets. lv_obj_set_style_* gives every
+// object its own local style, so style memory and cascade lookups grow with the
+// page count; here each distinct look is built once and attached to every object
+// that wears it. Page backgrounds are refcounted per bg/bg2/painted tuple and
+// freed with their last object. LVGL thread only.
+namespace style_pool {
+
+// Macro page container: bg colour, LVGL gradient when bg2 differs, no pad/border/radius.
+// `painted`: a gradient row table draws the background, so bg stays transparent.
+lv_style_t* page(uint32_t bg, uint32_t bg2, bool painted);
+lv_style_t* clock_page();    // black, no pad/border
+lv_style_t* clock_label();   // white text, date font
+lv_style_t* tap_dot();       // white circle
+
+void attach(lv_obj_t* obj, lv_style_t* s);   // main part, default state
+void detach(lv_obj_t* obj, lv_style_t* s);   // a page style is freed with its last object
+
+struct Stats {
+  uint32_t styles;        // shared styles alive
+  uint32_t attached;      // objects wearing one
+  uint32_t bytes_saved;   // local styles those objects would hold, less the shared ones
+};
+Stats stats();
+
+} // namespace style_pool
@@ -0,0 +1,116 @@
+#include "touch.hpp"
+#include "touch_filter.hpp"
+#include "lf_queue.hpp"
+#include <LittleFS.h>
+extern "C" {
+  #include "esp_timer.h"
+  #include "esp_heap_caps.h"
+}
+
+namespace {
+
+constexpr uint32_t kPollWhileDownMs = 40;   // re-read if the release interrupt goes missing
+constexpr uint32_t kRepeatUs = 60000;       // touch + gesture IRQ for one release land well inside this
+
+CST816S* g_dev = nullptr;
+TaskHandle_t g_task = nullptr;
+TaskHandle_t g_wake = nullptr;
+LfQueue<touch::Sample, 64> g_ring;
+touch::Stats g_stats{};
+touch::Filter g_filter;                     // touch task only
+
+// Raw trace recording: the touch task appends, record_stop() writes the file.
+// A sample is counted only after it's complete, so the reader never sees a torn one.
+constexpr size_t kTraceMax = 4096;          // ~80 s of continuous touch at 50 Hz
+touch::Sample* g_trace = nullptr;           // PSRAM, kept once allocated
+std::atomic<size_t> g_traceLen{0};
+std::atomic<bool> g_recording{false};
+
+void IRAM_ATTR on_irq(void*) {
+  if (!g_task) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(g_task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void touch_task(void*) {
+  bool down = false;
+  uint8_t lastGesture = 0;                  // gesture id of the last release report, 0 after a finger-down
+  uint32_t lastReleaseUs = 0;
+  for (;;) {
+    uint32_t irqs = ulTaskNotifyTake(pdTRUE, down ? pdMS_TO_TICKS(kPollWhileDownMs) : portMAX_DELAY);
+    g_stats.irqs += irqs;
+
+    touch_event_t ev;
+    const int64_t t0 = esp_timer_get_time();
+    bool ok = g_dev->getTouch(&ev);
+    g_stats.last_read_us = (uint32_t)(esp_timer_get_time() - t0);
+    g_dev->ready();   // clear the library's flag, we've consumed the interrupt
+    if (!ok) { g_stats.i2c_errors++; continue; }
+
+    touch::Sample s{ (uint32_t)t0, ev.x, ev.y, ev.gesture, ev.finger != 0 };
+    if (!s.down && !down) {
+      if (!irqs) continue;                                              // idle poll
+      // touch + gesture IRQ for one release; a later quick click with the same id is a new one
+      if (s.gesture == lastGesture && s.t_us - lastReleaseUs < kRepeatUs) { g_stats.repeats++; continue; }
+    }
+    down = s.down;
+    lastGesture = s.down ? 0 : s.gesture;
+    if (!s.down) lastReleaseUs = s.t_us;
+    if (g_recording.load(std::memory_order_acquire)) {
+      size_t n = g_traceLen.load(std::memory_order_relaxed);
+      if (n < kTraceMax) { g_trace[n] = s; g_traceLen.store(n + 1, std::memory_order_release); }
+    }
+    g_filter.apply(s);
+    if (g_ring.push(s)) g_stats.samples++;
+    else g_stats.overflows++;
+    if (g_wake) xTaskNotifyGive(g_wake);
+  }
+}
+
+} // anon
+
+namespace touch {
+
+bool begin(CST816S& dev) {
+  if (g_task) return true;
+  g_dev = &dev;
+  // above the LVGL task: a read is a few hundred us and must not queue behind a frame
+  if (xTaskCreatePinnedToCore(touch_task, "touch", 3072, nullptr, 4, &g_task, 1) != pdPASS) return false;
+  dev.onInterrupt(on_irq, nullptr);
+  return true;
+}
+
+bool read(Sample& out) { return g_ring.pop(out); }
+bool pending() { return !g_ring.empty(); }
+void wake_on_sample(TaskHandle_t task) { g_wake = task; }
+
+Stats stats() { return g_stats; }
+
+bool record_start() {
+  if (!g_trace) g_trace = (Sample*)heap_caps_malloc(kTraceMax * sizeof(Sample), MALLOC_CAP_SPIRAM);
+  if (!g_trace) return false;
+  g_recording.store(false);
+  g_traceLen.store(0);
+  g_recording.store(true, std::memory_order_release);
+  return true;
+}
+
+int record_stop(const char* path) {
+  if (!g_recording.exchange(false)) return -1;
+  const size_t n = g_traceLen.load(std::memory_order_acquire);
+  File f = LittleFS.open(path, "w");
+  if (!f) return -1;
+  f.write((const uint8_t*)kTraceMagic, sizeof(kTraceMagic));
+  uint8_t rec[kTraceRecord];
+  for (size_t i = 0; i < n; ++i) {
+    pack(g_trace[i], rec);
+    f.write(rec, sizeof(rec));
+  }
+  f.close();
+  return (int)n;
+}
+
+bool recording() { return g_recording.load(); }
+
+} // namespace touch
@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+#include <CST816S.h>
+#include "touch_sample.hpp"
+extern "C" {
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+}
+
+// Interrupt-driven CST816S sampling. The touch IRQ wakes a small task that
+// reads the controller, runs the coordinates through a one-euro filter and
+// queues timestamped samples; the LVGL input driver drains them, so the LVGL
+// task never waits on I2C.
+namespace touch {
+
+struct Stats {
+  uint32_t irqs;         // controller interrupts
+  uint32_t samples;      // samples queued
+  uint32_t overflows;    // samples lost because the consumer fell behind
+  uint32_t repeats;      // release reports dropped because they repeated the previous one
+  uint32_t i2c_errors;
+  uint32_t last_read_us; // duration of the last I2C read
+};
+
+bool begin(CST816S& dev);          // start the sampling task
+bool read(Sample& out);            // oldest queued sample (LVGL task only)
+bool pending();                    // samples waiting
+void wake_on_sample(TaskHandle_t task);  // task notified for every queued sample
+Stats stats();
+
+// Raw (unfiltered) trace capture for replay on the host (tools/trace_replay).
+bool record_start();
+int  record_stop(const char* path);   // samples written, -1 if not recording or the file failed
+bool recording();
+
+} // namespace touch
@@ -0,0 +1,60 @@
+#pragma once
+#include <math.h>
+#include "touch_sample.hpp"
+
+// One-euro filter (Casiez et al.) on touch coordinates: heavy smoothing while
+// the finger is still, almost none once it moves fast, so tap jitter is
+// flattened without adding lag to swipes. Plain C++ so traces can be replayed
+// through it on the host.
+namespace touch {
+
+struct FilterParams {
+  float min_cutoff_hz = 2.0f;   // smoothing at rest; lower = steadier taps
+  float beta          = 0.02f;  // cutoff increase per px/s of speed; higher = less swipe lag
+  float d_cutoff_hz   = 4.0f;   // smoothing of the speed estimate itself
+};
+
+class OneEuro {
+public:
+  void reset() { init_ = false; }
+  float apply(float x, float dt, const FilterParams& p) {
+    if (!init_ || dt <= 0.0f) { init_ = true; x_ = x; dx_ = 0.0f; return x; }
+    const float dx = (x - x_) / dt;
+    dx_ += alpha(p.d_cutoff_hz, dt) * (dx - dx_);
+    const float cutoff = p.min_cutoff_hz + p.beta * fabsf(dx_);
+    x_ += alpha(cutoff, dt) * (x - x_);
+    return x_;
+  }
+  float speed() const { return dx_; }   // px/s, filtered
+
+private:
+  static float alpha(float cutoff, float dt) {
+    const float tau = 1.0f / (6.2831853f * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+  }
+  bool init_ = false;
+  float x_ = 0.0f, dx_ = 0.0f;
+};
+
+// Filters a sample stream in place; restarts at every finger-down.
+class Filter {
+public:
+  FilterParams params;
+  void apply(Sample& s) {
+    if (s.down && !down_) { fx_.reset(); fy_.reset(); }
+    const float dt = down_ || !s.down ? (float)(s.t_us - t_) * 1e-6f : 0.0f;
+    if (s.down || down_) {
+      s.x = (uint16_t)lroundf(fx_.apply(s.x, dt, params));
+      s.y = (uint16_t)lroundf(fy_.apply(s.y, dt, params));
+    }
+    down_ = s.down;
+    t_ = s.t_us;
+  }
+
+private:
+  OneEuro fx_, fy_;
+  bool down_ = false;
+  uint32_t t_ = 0;
+};
+
+} // namespace touch
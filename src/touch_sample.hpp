@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+
+namespace touch {
+
+// One controller read. Plain data so the gesture code builds without Arduino.
+struct Sample {
+  uint32_t t_us;    // esp_timer time of the I2C read
+  uint16_t x, y;
+  uint8_t gesture;  // CST_GESTURE reported with this sample
+  bool down;
+};
+
+// Raw touch trace file (see touch::record_start): "KTR1", then kTraceRecord
+// bytes per sample, little endian: t_us u32, x u16, y u16, gesture u8, down u8.
+constexpr char kTraceMagic[4] = {'K', 'T', 'R', '1'};
+constexpr unsigned kTraceRecord = 10;
+
+inline void pack(const Sample& s, uint8_t* o) {
+  o[0] = (uint8_t)s.t_us; o[1] = (uint8_t)(s.t_us >> 8); o[2] = (uint8_t)(s.t_us >> 16); o[3] = (uint8_t)(s.t_us >> 24);
+  o[4] = (uint8_t)s.x;    o[5] = (uint8_t)(s.x >> 8);
+  o[6] = (uint8_t)s.y;    o[7] = (uint8_t)(s.y >> 8);
+  o[8] = s.gesture;
+  o[9] = s.down ? 1 : 0;
+}
+
+inline Sample unpack(const uint8_t* i) {
+  Sample s;
+  s.t_us = (uint32_t)i[0] | ((uint32_t)i[1] << 8) | ((uint32_t)i[2] << 16) | ((uint32_t)i[3] << 24);
+  s.x = (uint16_t)(i[4] | (i[5] << 8));
+  s.y = (uint16_t)(i[6] | (i[7] << 8));
+  s.gesture = i[8];
+  s.down = i[9] != 0;
+  return s;
+}
+
+} // namespace touch
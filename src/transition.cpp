@@ -0,0 +1,134 @@
+#include "transition.hpp"
+#include "lvgl_hal.h"
+extern "C" {
+  #include "esp_timer.h"
+  #include "esp_heap_caps.h"
+}
+
+namespace {
+
+constexpr uint32_t kDurationMs    = 240;    // whole slide, independent of achieved fps
+constexpr uint32_t kFrameBudgetUs = 16667;  // 60 fps; a late frame is skipped, never stretched
+constexpr int      kStripRows     = 20;     // rows composited per SPI push
+
+constexpr int W = TFT_WIDTH;
+constexpr int H = TFT_HEIGHT;
+
+lv_color_t* g_in    = nullptr;   // incoming page (PSRAM)
+lv_color_t* g_strip = nullptr;   // composited rows on their way to the panel (internal RAM)
+lv_timer_t* g_timer = nullptr;
+std::function<void()> g_done;
+transition::Dir g_dir = transition::Dir::Left;
+transition::Stats g_stats{};
+int64_t  g_t0 = 0;
+uint32_t g_nextSlot = 0;         // first frame slot not yet shown
+bool     g_active = false;
+
+// ease-out cubic: fast start so the page follows the finger, soft landing
+int offset_at(uint32_t ms){
+  if(ms >= kDurationMs) return W;
+  float p = 1.0f - (float)ms / (float)kDurationMs;
+  return (int)((1.0f - p*p*p) * W + 0.5f);
+}
+
+// Compose one frame where the pages have moved `off` pixels and push it.
+void push_frame(int off){
+  const lv_color_t* out = lvgl_hal_framebuffer();
+  tft_gc9a01.startWrite();
+  tft_gc9a01.setAddrWindow(0, 0, W, H);
+  for(int y0 = 0; y0 < H; y0 += kStripRows){
+    const int rows = LV_MIN(kStripRows, H - y0);
+    for(int r = 0; r < rows; ++r){
+      const lv_color_t* o = out  + (y0 + r) * W;
+      const lv_color_t* i = g_in + (y0 + r) * W;
+      lv_color_t* d = g_strip + r * W;
+      if(g_dir == transition::Dir::Left){
+        memcpy(d,           o + off, (W - off) * sizeof(lv_color_t));
+        memcpy(d + W - off, i,       off * sizeof(lv_color_t));
+      }else{
+        memcpy(d,           i + W - off, off * sizeof(lv_color_t));
+        memcpy(d + off,     o,           (W - off) * sizeof(lv_color_t));
+      }
+    }
+    tft_gc9a01.pushColors((uint16_t*)g_strip, rows * W, true);
+  }
+  tft_gc9a01.endWrite();
+}
+
+void end(){
+  g_active = false;
+  lv_timer_pause(g_timer);
+  g_stats.last_ms = (uint32_t)((esp_timer_get_time() - g_t0) / 1000);
+  if(lv_disp_t* disp = lv_disp_get_default()) lv_timer_resume(_lv_disp_get_refr_timer(disp));
+  auto done = std::move(g_done);
+  g_done = nullptr;
+  if(done) done();
+}
+
+void step(lv_timer_t*){
+  if(!g_active) return;
+  const int64_t now = esp_timer_get_time();
+  const uint32_t slot = (uint32_t)((now - g_t0) / kFrameBudgetUs);
+  if(slot < g_nextSlot) return;                    // timer fired early, this slot is already out
+  g_stats.dropped += slot - g_nextSlot;
+  g_nextSlot = slot + 1;
+
+  const int off = offset_at((uint32_t)((now - g_t0) / 1000));
+  push_frame(off);
+  g_stats.frames++;
+  const uint32_t spent = (uint32_t)(esp_timer_get_time() - now);
+  if(spent > g_stats.worst_frame_us) g_stats.worst_frame_us = spent;
+
+  if(off >= W) end();
+}
+
+} // anon
+
+namespace transition {
+
+bool begin(){
+  if(!g_in)    g_in = (lv_color_t*)heap_caps_malloc(W * H * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+  if(!g_strip) g_strip = (lv_color_t*)heap_caps_malloc(W * kStripRows * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if(!g_timer){
+    g_timer = lv_timer_create(step, kFrameBudgetUs / 1000, nullptr);
+    lv_timer_pause(g_timer);
+  }
+  return g_in && g_strip && g_timer;
+}
+
+bool start(lv_obj_t* incoming, Dir dir, std::function<void()> done){
+  if(g_active) finish();
+  if(!incoming || !g_in || !g_strip || !g_timer || !lvgl_hal_framebuffer()) return false;
+  lv_disp_t* disp = lv_disp_get_default();
+  if(!disp) return false;
+
+  lv_obj_update_layout(incoming);
+  lv_img_dsc_t dsc;
+  if(lv_snapshot_take_to_buf(incoming, LV_IMG_CF_TRUE_COLOR, &dsc, g_in, W * H * sizeof(lv_color_t)) != LV_RES_OK) return false;
+  if(dsc.header.w != W || dsc.header.h != H) return false;
+
+  // Nothing gets redrawn until the slide is over; pending invalidations render once at the end.
+  lv_timer_pause(_lv_disp_get_refr_timer(disp));
+
+  g_dir = dir;
+  g_done = std::move(done);
+  g_t0 = esp_timer_get_time();
+  g_nextSlot = 0;
+  g_active = true;
+  g_stats.runs++;
+  lv_timer_resume(g_timer);
+  lv_timer_ready(g_timer);   // first frame on the next handler pass
+  return true;
+}
+
+void finish(){
+  if(!g_active) return;
+  push_frame(W);
+  g_stats.frames++;
+  end();
+}
+
+bool active(){ return g_active; }
+Stats stats(){ return g_stats; }
+
+} // namespace transition
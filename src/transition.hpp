@@ -0,0 +1,31 @@
+#pragma once
+#include <lvgl.h>
+#include <functional>
+
+// Page slide engine. The outgoing page is taken from the panel shadow buffer,
+// the incoming page is captured once with lv_snapshot, and every frame is a
+// row-wise memcpy of both bitmaps pushed straight to the panel. LVGL's
+// display refresh is paused while a slide runs, so no widget is laid out or
+// redrawn until the final page is shown.
+namespace transition {
+
+enum class Dir { Left, Right };  // Left: incoming enters from the right (next page), Right: from the left
+
+struct Stats {
+  uint32_t runs;            // slides played
+  uint32_t frames;          // frames pushed to the panel
+  uint32_t dropped;         // frame slots skipped to stay on schedule
+  uint32_t last_ms;         // wall time of the last slide
+  uint32_t worst_frame_us;  // slowest composite + push
+};
+
+bool begin();                 // allocate capture + strip buffers
+// Slide `incoming` (already visible, full screen) over the current panel contents.
+// `done` runs on the LVGL thread when the last frame is out. Returns false if the
+// slide can't run; the caller should swap pages instantly then.
+bool start(lv_obj_t* incoming, Dir dir, std::function<void()> done);
+void finish();                // jump to the end of a running slide
+bool active();
+Stats stats();
+
+} // namespace transition
@@ -2,99 +2,155 @@
 #include <lvgl.h>
 #include "widgets.hpp"
 #include "fs_lvgl.hpp"
+#include "transition.hpp"
+#include "lf_queue.hpp"
+#include "touch.hpp"
+#include "input.hpp"
+#include "render_stats.hpp"
+#include "power.hpp"
+#include "splash.hpp"
+#include "boot.hpp"
+#include "lvgl_hal.h"
 #include <LittleFS.h>
-#include <vector>
+#include <mutex>
+extern "C" {
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+}
 
 namespace {
 static lv_obj_t* scr;
 static lv_obj_t* content;
-static std::vector<widgets::Widget*> g_widgets;
-static uint8_t cur = 0;
-static lv_point_t g_press_pt; static bool g_moved=false;
+static uint16_t cur = 0;
 static lv_timer_t* g_tickTimer = nullptr;
+static uint32_t g_appliedRev = 0;
 static lv_obj_t* wifiDlg = nullptr;
 
-static uint8_t total_pages(){ return storage::count() + 1; } // 0=Clock, 1..N=Macros
+// LVGL runs in its own task; everyone else talks to the UI through this queue.
+constexpr uint32_t kFramePeriodMs = LV_DISP_DEF_REFR_PERIOD;
+enum class Cmd : uint8_t { WifiFailed, WifiOk, Ble, ProfileChanged, Show, Overlay, Power };
+struct UiCmd { Cmd cmd; uint32_t arg; };
+static LfQueue<UiCmd, 32> g_cmds;
+static std::atomic<uint32_t> g_cmdDropped{0};
+static TaskHandle_t g_task = nullptr;
+// Too big for a command's arg: the latest config waits here, Cmd::Power picks it up.
+static std::mutex g_powerMtx;
+static power::Config g_powerPending;
+static ui::LoopStats g_loop{};
+
+static void post(Cmd cmd, uint32_t arg = 0){
+  if(!g_cmds.push({cmd, arg})) g_cmdDropped++;
+  if(g_task) xTaskNotifyGive(g_task);   // the LVGL task may be asleep until its next timer
 }
 
-namespace ui {
+// Only the clock and the macro pages around `cur` have LVGL objects. Three recycled
+// macro widgets cover prev/cur/next, so UI memory doesn't grow with the slot count.
+// Each object remembers which slot (handle) and revision it shows.
+struct PageObj { widgets::Widget* w; int32_t page; uint32_t handle; uint32_t rev; };
+static widgets::Widget* g_clock = nullptr;
+static PageObj g_pool[3] = {{nullptr,-1,0,0},{nullptr,-1,0,0},{nullptr,-1,0,0}};
 
-void begin() {
-  lv_fs_littlefs_init();
+static uint16_t total_pages(){ return storage::count() + 1; } // 0=Clock, 1..N=Macros
+static uint16_t wrap(int32_t p){ int32_t n = total_pages(); return (uint16_t)(((p % n) + n) % n); }
+static bool in_window(int32_t p){ return p == cur || p == wrap(cur - 1) || p == wrap(cur + 1); }
 
-  // Make display background pure black (covers any uncovered pixels)
-  lv_disp_t* disp = lv_disp_get_default();
-  if (disp) {
-    lv_disp_set_bg_color(disp, lv_color_black());
-    lv_disp_set_bg_opa(disp, LV_OPA_COVER);
+// Widget showing `page`, rebinding a pool object that fell out of the window if needed.
+static widgets::Widget* page_widget(uint16_t page){
+  if(page == 0) return g_clock;
+  for(auto& o : g_pool) if(o.w && o.page == page) return o.w;
+  macros::Slot slot;
+  if(!storage::read_slot(page - 1, slot)) return nullptr;
+  PageObj* victim = nullptr;
+  for(auto& o : g_pool){
+    if(!o.w || o.page < 0 || !in_window(o.page)){ victim = &o; break; }
   }
+  // jumping far away (ui::show): anything but the visible page may go
+  if(!victim) for(auto& o : g_pool) if(o.page != cur){ victim = &o; break; }
+  if(!victim) return nullptr;
+  if(!victim->w) victim->w = widgets::createMacro(content, slot);
+  else           victim->w->bind(slot);
+  victim->w->hide();
+  victim->page = page;
+  victim->handle = slot.handle;
+  victim->rev = slot.rev;
+  return victim->w;
+}
 
-  scr = lv_obj_create(NULL);
-  lv_obj_set_size(scr, LV_HOR_RES, LV_VER_RES);
-  lv_obj_set_style_pad_all(scr, 0, 0);
-  lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_set_scrollbar_mode(scr, LV_SCROLLBAR_MODE_OFF);
-  lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
-  lv_obj_set_style_border_width(scr, 0, 0);
-
-  content = lv_obj_create(scr);
-  lv_obj_set_size(content, LV_PCT(100), LV_PCT(100));
-  lv_obj_set_style_pad_all(content, 0, 0);
-  lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_set_scrollbar_mode(content, LV_SCROLLBAR_MODE_OFF);
-  lv_obj_set_style_bg_opa(content, LV_OPA_TRANSP, 0);
-  lv_obj_set_style_border_width(content, 0, 0);
-
-  // Build widgets: index 0 = Clock
-  g_widgets.clear();
-  g_widgets.push_back(widgets::createClock(content));
-  // then each macro slot
-  for (uint8_t i=0; i<storage::count(); ++i) {
-    g_widgets.push_back(widgets::createMacro(content, storage::get_slot(i)));
-  }
-  // Hide all except current
-  for (size_t i=0;i<g_widgets.size();++i) {
-    if(i==cur) g_widgets[i]->show(); else g_widgets[i]->hide();
-  }
+// Tell the input dispatcher which slot is under the finger (only slots with a
+// double-tap action make their single taps wait) and render stats which page draws.
+static void retarget(){
+  render_stats::set_page(cur);
+  macros::Slot s;
+  if(cur == 0 || !storage::read_slot(cur - 1, s)){ input::set_target(0, 0); return; }
+  input::set_target(s.handle, s.doubleTap.set() ? s.doubleTapMs : 0);
+}
 
-  // Tap vs swipe handling (like before, but delegate tap)
-  lv_obj_add_event_cb(scr, [](lv_event_t* e){
-    auto code = lv_event_get_code(e);
-    if(code==LV_EVENT_PRESSED){ lv_indev_get_point(lv_indev_get_act(), &g_press_pt); g_moved=false; }
-    else if(code==LV_EVENT_PRESSING){
-      lv_point_t p; lv_indev_get_point(lv_indev_get_act(), &p);
-      if (LV_ABS(p.x-g_press_pt.x)>12 || LV_ABS(p.y-g_press_pt.y)>12) g_moved = true;
-    } else if(code==LV_EVENT_RELEASED){
-      if(!g_moved && cur < g_widgets.size()) g_widgets[cur]->onTap();
-    }
-  }, LV_EVENT_ALL, NULL);
+// Bind the neighbours ahead of time so the next swipe only has to snapshot them.
+static void prefetch(){
+  page_widget(wrap(cur + 1));
+  page_widget(wrap(cur - 1));
+}
 
-  // Swipe gestures switch pages
-  lv_obj_add_event_cb(scr, [](lv_event_t*){
-    lv_dir_t d = lv_indev_get_gesture_dir(lv_indev_get_act());
-    if(d==LV_DIR_LEFT){ if(total_pages()>0){ uint8_t n=total_pages(); cur=(cur+1)%n; } }
-    else if(d==LV_DIR_RIGHT){ if(total_pages()>0){ uint8_t n=total_pages(); cur=(cur==0)?(n-1):(cur-1);} }
-    // Show only the current widget
-    for (size_t i=0;i<g_widgets.size();++i) (i==cur)? g_widgets[i]->show() : g_widgets[i]->hide();
-  }, LV_EVENT_GESTURE, NULL);
+// Switch pages with a bitmap slide; falls back to an instant swap when the slide can't run
+// (e.g. a dialog on the top layer would be cut off by the captured bitmaps).
+static void go_to(uint16_t next, transition::Dir dir){
+  if(next == cur || next >= total_pages()) return;
+  transition::finish();
+  widgets::Widget* from = page_widget(cur);
+  widgets::Widget* to   = page_widget(next);
+  if(!to) return;
+  cur = next;
+  retarget();
+  to->show();
+  auto done = [from](){ if(from) from->hide(); prefetch(); };
+  if(wifiDlg || !transition::start(to->root(), dir, done)) done();
+}
 
-  lv_scr_load(scr);
+// Bring the bound pages in line with the slot store after an edit: the visible
+// page follows its slot's handle, only pages whose slot changed are rebound,
+// and pages past the end are dropped.
+static void sync_pages(){
+  transition::finish();
+  uint32_t curHandle = 0;
+  for(auto& o : g_pool) if(o.w && o.page == cur) curHandle = o.handle;
+  if(curHandle){
+    int32_t idx = storage::index_of(curHandle);
+    if(idx >= 0) cur = idx + 1;
+  }
+  if(cur >= total_pages()) cur = total_pages() - 1;
+  retarget();
 
-  if(!g_tickTimer){
-    g_tickTimer = lv_timer_create([](lv_timer_t*){
-      if(cur < g_widgets.size()) g_widgets[cur]->tick(500);
-    }, 500, nullptr);
+  for(auto& o : g_pool){
+    if(!o.w || o.page < 0) continue;
+    macros::Slot s;
+    if(o.page >= total_pages() || !storage::read_slot(o.page - 1, s)){ o.w->hide(); o.page = -1; continue; }
+    if(s.handle == o.handle && s.rev == o.rev) continue;
+    o.w->bind(s);
+    o.handle = s.handle;
+    o.rev = s.rev;
   }
+
+  widgets::Widget* vis = page_widget(cur);
+  if(g_clock != vis) g_clock->hide();
+  for(auto& o : g_pool) if(o.w && o.w != vis) o.w->hide();
+  if(vis) vis->show();
+  prefetch();
 }
 
-void show(uint8_t index){
+static void show_page(uint16_t index){
+  if(index >= total_pages()) return;
+  transition::finish();
+  widgets::Widget* from = page_widget(cur);
+  widgets::Widget* to   = page_widget(index);
+  if(!to) return;
   cur = index;
-  for (size_t i=0;i<g_widgets.size();++i) (i==cur)? g_widgets[i]->show() : g_widgets[i]->hide();
+  retarget();
+  if(from && from != to) from->hide();
+  to->show();
+  prefetch();
 }
 
-void notify_ble(bool){ /* no BLE pill in minimal UI */ }
-
-void wifi_failed(){
+static void show_wifi_dialog(){
   if (wifiDlg) return;
   wifiDlg = lv_obj_create(lv_layer_top());
   lv_obj_set_size(wifiDlg, LV_PCT(80), LV_SIZE_CONTENT);
@@ -124,8 +180,203 @@ void wifi_failed(){
   lv_obj_set_flex_align(row, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 }
 
-void wifi_ok(){ if (wifiDlg) { lv_obj_del(wifiDlg); wifiDlg=nullptr; } }
+static void hide_wifi_dialog(){ if (wifiDlg) { lv_obj_del(wifiDlg); wifiDlg=nullptr; } }
+
+// Runs on the LVGL task before each timer pass.
+static void drain(){
+  UiCmd c;
+  while(g_cmds.pop(c)){
+    switch(c.cmd){
+      case Cmd::WifiFailed:     show_wifi_dialog(); break;
+      case Cmd::WifiOk:         hide_wifi_dialog(); break;
+      case Cmd::Ble:            break;   // no BLE pill in minimal UI
+      case Cmd::ProfileChanged: break;   // wake-up only, the revision check below does the work
+      case Cmd::Show:           power::wake(0); show_page((uint16_t)c.arg); break;
+      case Cmd::Overlay:        render_stats::set_overlay(c.arg != 0); break;
+      case Cmd::Power: {
+        power::Config pc;
+        { std::lock_guard<std::mutex> lk(g_powerMtx); pc = g_powerPending; }
+        power::configure(pc);
+        break;
+      }
+    }
+  }
+  // compare revisions rather than trusting the queue, so a dropped command can't strand the UI
+  uint32_t rev = storage::revision();
+  if(rev != g_appliedRev){
+    g_appliedRev = rev;
+    sync_pages();
+  }
+}
+
+// Every gesture lands here exactly once: swipes turn pages, everything else goes to the page.
+// The Release edge goes to whichever page got the Press, even if a swipe moved on since.
+static widgets::Widget* g_pressed = nullptr;
+static bool g_swallow = false;   // the gesture that woke the panel does nothing else
+static void on_input(const gesture::Event& ev){
+  const bool woke = power::wake(ev.t_us);
+  if(woke) g_swallow = ev.kind == gesture::Kind::Press;   // then everything up to its Release
+  if(woke || g_swallow){
+    if(ev.kind == gesture::Kind::Release) g_swallow = false;
+    return;
+  }
+  if(ev.kind == gesture::Kind::Release){
+    if(g_pressed) g_pressed->onInput(ev);
+    g_pressed = nullptr;
+    return;
+  }
+  if(wifiDlg) return;   // the dialog's buttons get their clicks through LVGL
+  uint16_t n = total_pages();
+  switch(ev.kind){
+    case gesture::Kind::SwipeLeft:  go_to((cur+1)%n, transition::Dir::Left); break;
+    case gesture::Kind::SwipeRight: go_to((cur==0)?(n-1):(cur-1), transition::Dir::Right); break;
+    case gesture::Kind::Press:
+      g_pressed = page_widget(cur);
+      if(g_pressed) g_pressed->onInput(ev);
+      break;
+    default:
+      if(ev.kind == gesture::Kind::Tap) boot::tap();
+      if(auto w = page_widget(cur)) w->onInput(ev);
+      break;
+  }
+}
+
+// The display refresh timer only runs while something is invalid, so a static page
+// costs no wake-ups. Returns how long the task may sleep as far as redraws go.
+// A slide owns the timer while it plays (transition.cpp).
+static uint32_t gate_refresh(){
+  lv_disp_t* disp = lv_disp_get_default();
+  if(!disp || transition::active()) return LV_NO_TIMER_READY;
+  lv_timer_t* refr = _lv_disp_get_refr_timer(disp);
+  if(!disp->inv_p || power::display_off()){ lv_timer_pause(refr); return LV_NO_TIMER_READY; }
+  if(!refr->paused) return kFramePeriodMs;
+  lv_timer_resume(refr);
+  lv_timer_ready(refr);
+  return 0;
+}
+
+// One scheduler pass: queued commands, LVGL timers (touch read, redraw), then gestures.
+// Returns how long the task may sleep (ms, LV_NO_TIMER_READY: until woken).
+static uint32_t pass(){
+  drain();
+  uint32_t wait = lv_timer_handler();
+  input::dispatch();
+  wait = LV_MIN(wait, gate_refresh());
+  if(input::busy()) wait = LV_MIN(wait, kFramePeriodMs);   // finger down or a tap waiting for its twin
+  g_loop.passes++;
+  g_loop.last_sleep_ms = wait;
+  return wait;
+}
+
+#ifndef KNOMI_SIM
+// Event driven: sleeps until the next LVGL timer is due, a touch sample arrives or
+// another task posts a command. On a static page only the clock's tick is left.
+static void lvgl_task(void*){
+  touch::wake_on_sample(xTaskGetCurrentTaskHandle());
+  for(;;){
+    const uint32_t wait = pass();
+    if(!wait) continue;
+    const TickType_t ticks = wait == LV_NO_TIMER_READY ? portMAX_DELAY : LV_MAX(pdMS_TO_TICKS(wait), 1);
+    if(ulTaskNotifyTake(pdTRUE, ticks)){
+      g_loop.early_wakes++;
+      if(touch::pending()) lvgl_hal_touch_kick();
+    }
+  }
+}
+#endif
+}
+
+namespace ui {
+
+void begin() {
+  lv_fs_littlefs_init();
+  transition::begin();
+
+  // Make display background pure black (covers any uncovered pixels)
+  lv_disp_t* disp = lv_disp_get_default();
+  if (disp) {
+    lv_disp_set_bg_color(disp, lv_color_black());
+    lv_disp_set_bg_opa(disp, LV_OPA_COVER);
+  }
+
+  scr = lv_obj_create(NULL);
+  lv_obj_set_size(scr, LV_HOR_RES, LV_VER_RES);
+  lv_obj_set_style_pad_all(scr, 0, 0);
+  lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_scrollbar_mode(scr, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+  lv_obj_set_style_border_width(scr, 0, 0);
+
+  content = lv_obj_create(scr);
+  lv_obj_set_size(content, LV_PCT(100), LV_PCT(100));
+  lv_obj_set_style_pad_all(content, 0, 0);
+  lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_scrollbar_mode(content, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_set_style_bg_opa(content, LV_OPA_TRANSP, 0);
+  lv_obj_set_style_border_width(content, 0, 0);
+
+  // Page 0 = Clock; macro pages are bound on demand around the current one
+  g_clock = widgets::createClock(content);
+  g_clock->hide();
+  if(cur >= total_pages()) cur = 0;
+  page_widget(cur)->show();
+  prefetch();
+
+  input::begin(on_input);
+  retarget();
+
+  lv_scr_load(scr);
+
+  // Profile edits from the web API are applied on the LVGL task
+  g_appliedRev = storage::revision();
+  storage::on_change([](uint32_t rev){ post(Cmd::ProfileChanged, rev); });
+
+  if(!g_tickTimer){
+    g_tickTimer = lv_timer_create([](lv_timer_t*){
+      if(auto w = page_widget(cur)) w->tick(500);
+    }, 500, nullptr);
+  }
+
+  // Nothing ticks while the panel sleeps; on wake the clock catches up at once
+  power::begin([](bool on){
+    if(on){ lv_timer_resume(g_tickTimer); lv_timer_ready(g_tickTimer); }
+    else{ lv_timer_pause(g_tickTimer); splash::save_idle(); }
+  });
+  splash::begin();
+
+#ifndef KNOMI_SIM
+  // From here on only the LVGL task touches LVGL. Pinned next to the Arduino loop
+  // but above it, so web/network work can't stall rendering or touch.
+  if(!g_task) xTaskCreatePinnedToCore(lvgl_task, "lvgl", 8192, nullptr, 3, &g_task, 1);
+#endif
+}
+
+#ifdef KNOMI_SIM
+void pump(){ pass(); }
+#endif
+
+void show(uint16_t index){ post(Cmd::Show, index); }
+
+void notify_ble(bool on){
+  static int8_t last = -1;   // only changes are worth a queue slot
+  if(last == (int8_t)on) return;
+  last = on;
+  post(Cmd::Ble, on);
+}
+
+void wifi_failed(){ post(Cmd::WifiFailed); }
+
+void render_overlay(bool on){ post(Cmd::Overlay, on); }
+
+void wifi_ok(){ post(Cmd::WifiOk); }
+
+void set_power(const power::Config& c){
+  { std::lock_guard<std::mutex> lk(g_powerMtx); g_powerPending = c; }
+  post(Cmd::Power);
+}
+
+uint16_t current_index(){ return cur; }
 
-uint8_t current_index(){ return cur; }
+LoopStats loop_stats(){ return g_loop; }
 
 } // namespace ui
@@ -1,11 +1,26 @@
 #pragma once
 #include <Arduino.h>
+#include "power.hpp"
 
+// Everything but begin() may be called from any task: calls are queued and
+// applied on the LVGL task.
 namespace ui {
-void begin();                // build screens
-void show(uint8_t index);    // show slot index
+void begin();                // build screens, then start the LVGL task
+void show(uint16_t index);   // show page index (0 = clock)
 void notify_ble(bool on);    // status pill
 void wifi_failed();         // show STA failure dialog
 void wifi_ok();             // hide dialog if shown
-uint8_t current_index();    // expose current index
+uint16_t current_index();   // expose current index
+void render_overlay(bool on); // frame-time overlay (render_stats)
+void set_power(const power::Config& c);   // power::configure() on the LVGL task
+
+struct LoopStats {
+  uint32_t passes;          // LVGL task passes
+  uint32_t early_wakes;     // passes started by a touch sample or a posted command
+  uint32_t last_sleep_ms;   // how long the last pass let the task sleep (UINT32_MAX: until woken)
+};
+LoopStats loop_stats();
+#ifdef KNOMI_SIM
+void pump();                // host simulator: one LVGL task pass, run by the caller (sim/main.cpp)
+#endif
 } // namespace ui
@@ -9,12 +9,30 @@
 #include "net.hpp"
 #include "rtc_time.hpp"
 #include "ble_hid.hpp"
+#include "input.hpp"
+#include "touch.hpp"
+#include "render_stats.hpp"
+#include "gradient.hpp"
+#include "style_pool.hpp"
+#include "lvgl_mem.h"
+#include "splash.hpp"
+#include "cpu_load.hpp"
+#include "boot.hpp"
+#include "coex.hpp"
+#include "power.hpp"
+#include "transition.hpp"
+#include "ui.hpp"
 #include <NimBLEDevice.h>
 
 static WebServer server(80);
+
+// First in the handler chain: sees every request, handles none. Keeps Wi-Fi up while the editor is used.
+struct ActivityTap : public RequestHandler {
+  bool canHandle(HTTPMethod, String) override { coex::web_activity(); return false; }
+};
 static File g_upFile;
 static String g_upExt;
-static uint8_t g_upId = 0;
+static uint16_t g_upId = 0;
 
 static String mimeFor(const String& path){
   if(path.endsWith(".png")) return "image/png";
@@ -95,9 +113,10 @@ hr.sep{border:none;border-top:1px solid var(--border);margin:12px 0}
       </div>
 
       <!-- Row 3: Reset (red), Sync, Add Macro (right) -->
-      <div class="row" style="grid-template-columns: 1fr 1fr 1fr; align-items:center;">
+      <div class="row" style="grid-template-columns: 1fr 1fr 1fr 1fr; align-items:center;">
         <button class="btn red" onclick="factoryReset()">Firmware Reset</button>
         <button class="btn" onclick="syncTime()">Sync Time & Date</button>
+        <button class="btn gray" onclick="toggleOverlay()">Frame Overlay</button>
         <div style="display:flex; gap:10px; justify-content:flex-end; align-items:center;">
           <div id="toolbarStatus" class="badge hidden">SAVED!</div>
           <button class="btn" onclick="addMacro()">Add Macro</button>
@@ -155,6 +174,39 @@ function renderCard(s, idx){
   updateHelp();
   grid.appendChild(sel); grid.appendChild(help); type.appendChild(grid); card.appendChild(type);
 
+  // Trigger
+  const trig = el('div','section'); trig.appendChild(el('div','label','Fire:'));
+  const tgrid = el('div','row');
+  const tsel = el('select'); tsel.innerHTML = `
+    <option value="release"${(s.trigger||'release')==='release'?' selected':''}>On tap</option>
+    <option value="press"${s.trigger==='press'?' selected':''}>On press</option>
+    <option value="hold"${s.trigger==='hold'?' selected':''}>Hold while pressed</option>`;
+  const thelp = el('div','helper','');
+  function updateTrigHelp(){
+    if(tsel.value==='press')     thelp.innerHTML = 'Fires the moment you touch. A swipe that starts on this page fires it too.';
+    else if(tsel.value==='hold') thelp.innerHTML = 'Holds a single key combo (e.g. <b>F13</b>) until you lift your finger. Other macros fire on press.';
+    else                         thelp.innerHTML = 'Fires after a quick tap.';
+  }
+  tsel.addEventListener('change', updateTrigHelp);
+  updateTrigHelp();
+  tgrid.appendChild(tsel); tgrid.appendChild(thelp); trig.appendChild(tgrid); card.appendChild(trig);
+
+  // Secondary bindings: empty macro = unbound
+  const typeOpts = (v)=> ['keystroke','typing','holdseq','keybind'].map(t=>`<option value="${t}"${v===t?' selected':''}>${t}</option>`).join('');
+  function binding(label, b){
+    const sec = el('div','section'); sec.appendChild(el('div','label',label));
+    const row = el('div','row');
+    const bs = el('select'); bs.innerHTML = typeOpts((b&&b.type)||'keybind');
+    const bi = el('input','input'); bi.placeholder='(none)'; bi.value=(b&&b.payload)||'';
+    row.appendChild(bs); row.appendChild(bi); sec.appendChild(row); card.appendChild(sec);
+    return ()=> bi.value.trim() ? {type:bs.value, payload:bi.value} : null;
+  }
+  const dblGet = binding('Double tap:', s.double);
+  const dblMs = el('input','input'); dblMs.type='number'; dblMs.min=100; dblMs.max=600; dblMs.step=10; dblMs.value = s.doubleMs||250;
+  card.lastChild.appendChild(el('div','helper','Wait (ms) for a second tap. Only pages with a double‑tap action wait; others fire at once.'));
+  card.lastChild.appendChild(dblMs);
+  const longGet = binding('Long press:', s.long);
+
   // Macro text
   const mac = el('div','section'); mac.appendChild(el('div','label','Macro:'));
   const ta = el('textarea'); ta.value = s.payload||''; mac.appendChild(ta); card.appendChild(mac);
@@ -232,6 +284,10 @@ function renderCard(s, idx){
       id:s.id,
       title:nameIn.value.trim(),
       type:sel.value,
+      trigger:tsel.value,
+      double: dblGet(),
+      long: longGet(),
+      doubleMs: parseInt(dblMs.value)||250,
       payload:ta.value,
       bg: fromHex(c1In.value),
       bg2: fromHex(c2In.value),
@@ -268,6 +324,7 @@ function syncTime(){
   }).catch(()=>{ const s=document.getElementById('toolbarStatus'); showErr(s); });
 }
 async function factoryReset(){ if(!confirm('Factory reset? This clears macros, icons, and Wi-Fi settings.')) return; const r=await fetch('/api/factory_reset',{method:'POST'}); const s=document.getElementById('toolbarStatus'); if(r.ok) showOk(s); else showErr(s); load(); }
+async function toggleOverlay(){ const r=await fetch('/api/render-overlay',{method:'POST',headers:{'Content-Type':'application/json'},body:'{}'}); const s=document.getElementById('toolbarStatus'); if(r.ok){ s.className='badge'; s.textContent='OVERLAY '+(await r.text()).toUpperCase(); } else showErr(s); }
 async function addMacro(){ const r=await fetch('/api/add',{method:'POST'}); if(r.ok) load(); else { const s=document.getElementById('toolbarStatus'); showErr(s,'ERROR! Could not add macro'); } }
 
 load();
@@ -336,42 +393,28 @@ static void handle_index(){
   }
 }
 
-static void handle_pages() {
-  send_json([](JsonDocument& d){
-    auto& prof = storage::profile();
-    JsonArray arr = d.createNestedArray("slots");
-    for (auto& s : prof.slots) {
-      JsonObject o = arr.createNestedObject();
-      o["id"] = s.id;
-      o["title"] = s.title;
-      switch (s.type) {
-        case macros::Type::Keystroke: o["type"] = "keystroke"; break;
-        case macros::Type::Typing:    o["type"] = "typing";    break;
-        case macros::Type::HoldSeq:   o["type"] = "holdseq";  break;
-        default:                      o["type"] = "keybind";   break;
-      }
-      o["payload"] = s.payload;
-      o["bg"] = s.bg;
-      o["bg2"] = s.bg2;
-      o["gradient"] = s.gradient;
-      o["iconPath"] = s.iconPath;
-    }
-  });
-}
-
-static void handle_export(){
-  auto& p = storage::profile();
-  StaticJsonDocument<4096> d;
-  JsonArray arr = d.createNestedArray("slots");
-  for (auto& s : p.slots){
-    JsonObject o=arr.createNestedObject();
-    o["id"]=s.id; o["title"]=s.title; o["payload"]=s.payload; o["iconPath"]=s.iconPath; o["bg"]=s.bg; o["bg2"]=s.bg2; o["gradient"]=s.gradient;
-    switch(s.type){case macros::Type::Keystroke:o["type"]="keystroke";break;case macros::Type::Typing:o["type"]="typing";break;case macros::Type::HoldSeq:o["type"]="holdseq";break;default:o["type"]="keybind";}
+// Slots are streamed as a chunked response, one slot per JSON document
+static void send_slots(){
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  server.sendContent("{\"slots\":[");
+  StaticJsonDocument<1536> d;
+  auto& prof = storage::profile();
+  for (size_t i = 0; i < prof.slots.size(); ++i) {
+    d.clear();
+    storage::slot_to_json(prof.slots[i], d.to<JsonObject>());
+    String out; if (i) out = ",";
+    serializeJson(d, out);
+    server.sendContent(out);
   }
-  String out; serializeJson(d,out);
-  server.send(200,"application/json",out);
+  server.sendContent("]}");
+  server.sendContent("");
 }
 
+static void handle_pages() { send_slots(); }
+
+static void handle_export(){ send_slots(); }
+
 // Recursively delete a folder (icons)
 static void rmrf(const char* path){
   File dir = LittleFS.open(path);
@@ -395,23 +438,15 @@ static void handle_hidtest(){
 
 static void handle_import(){
   String body = server.arg("plain");
-  StaticJsonDocument<4096> d;
+  DynamicJsonDocument d(body.length() * 2 + 1024);
   if (deserializeJson(d,body)){ server.send(400,"text/plain","bad json"); return; }
   storage::Profile np;
-  for (JsonObject s : d["slots"].as<JsonArray>()){
+  for (JsonObjectConst s : d["slots"].as<JsonArrayConst>()){
     macros::Slot sl;
-    sl.id = s["id"] | 0;
-    sl.title = String((const char*)s["title"]);
-    sl.payload = String((const char*)s["payload"]);
-    sl.iconPath = String((const char*)s["iconPath"]);
-    sl.bg = s["bg"] | 0x2D9BF0;
-    sl.bg2 = s["bg2"] | sl.bg;
-    sl.gradient = s["gradient"] | false;
-    String t = String((const char*)s["type"]); t.toLowerCase();
-    sl.type = (t=="keystroke")?macros::Type::Keystroke:(t=="typing")?macros::Type::Typing:(t=="holdseq")?macros::Type::HoldSeq:macros::Type::Keybind;
+    storage::slot_from_json(s, sl);
     np.slots.push_back(sl);
   }
-  storage::save(np); storage::load(); // persist & reload
+  storage::save(np); storage::replace(std::move(np)); // persist & publish
   server.send(200,"text/plain","ok");
 }
 
@@ -419,14 +454,14 @@ static void handle_import(){
 static void handle_add(){
   auto& p = storage::profile();
   macros::Slot s;
-  s.id = p.slots.empty()? 0 : (uint8_t)(p.slots.back().id + 1);
+  s.id = p.slots.empty()? 0 : (uint16_t)(p.slots.back().id + 1);
   s.title = String("Macro ") + (int)(p.slots.size()+1);
   s.type = macros::Type::Keystroke;
   s.payload = "";
   s.bg = 0x2d2f38;
   s.bg2 = s.bg;
   s.gradient = true;
-  p.slots.push_back(s);
+  storage::add_slot(s);
   storage::save();
   String out; out.reserve(32);
   out = "{\"id\":" + String((int)s.id) + "}";
@@ -463,21 +498,28 @@ static void handle_settime(){
 
 static void handle_save_page() {
   String body = server.arg("plain");
-  StaticJsonDocument<512> doc;
+  StaticJsonDocument<1024> doc;
   if (deserializeJson(doc, body)) { server.send(400, "text/plain", "bad json"); return; }
-  uint8_t id = doc["id"] | 0;
-  auto s = storage::get_slot(id);
-  if (!s) { macros::Slot ns; ns.id=id; storage::set_slot(id, ns); s = storage::get_slot(id); }
-  s->title = String((const char*)doc["title"]);
-  s->payload = String((const char*)doc["payload"]);
-  if (doc.containsKey("bg"))       s->bg = (uint32_t) doc["bg"].as<unsigned long>();
-  if (doc.containsKey("bg2"))      s->bg2 = (uint32_t) doc["bg2"].as<unsigned long>();
-  if (doc.containsKey("gradient")) s->gradient = (bool) doc["gradient"];
+  long rawId = doc["id"] | 0L;
+  if (rawId < 0 || rawId > storage::count()) { server.send(400, "text/plain", "id out of range"); return; }
+  uint16_t id = (uint16_t)rawId;
+  macros::Slot s{};
+  storage::read_slot(id, s);   // edit a copy; set_slot publishes it
+  s.title = String((const char*)doc["title"]);
+  s.payload = String((const char*)doc["payload"]);
+  if (doc.containsKey("bg"))       s.bg = (uint32_t) doc["bg"].as<unsigned long>();
+  if (doc.containsKey("bg2"))      s.bg2 = (uint32_t) doc["bg2"].as<unsigned long>();
+  if (doc.containsKey("gradient")) s.gradient = (bool) doc["gradient"];
+  if (doc.containsKey("trigger"))  s.trigger = macros::trigger_from_string(String((const char*)doc["trigger"]));
+  if (doc.containsKey("double"))   storage::binding_from_json(doc["double"].as<JsonObjectConst>(), s.doubleTap);
+  if (doc.containsKey("long"))     storage::binding_from_json(doc["long"].as<JsonObjectConst>(), s.longPress);
+  if (doc.containsKey("doubleMs")) s.doubleTapMs = constrain((int)doc["doubleMs"], 100, 600);
   String t = String((const char*)doc["type"]); t.toLowerCase();
-  if (t=="keystroke") s->type = macros::Type::Keystroke;
-  else if (t=="typing") s->type = macros::Type::Typing;
-  else if (t=="holdseq") s->type = macros::Type::HoldSeq;
-  else s->type = macros::Type::Keybind;
+  if (t=="keystroke") s.type = macros::Type::Keystroke;
+  else if (t=="typing") s.type = macros::Type::Typing;
+  else if (t=="holdseq") s.type = macros::Type::HoldSeq;
+  else s.type = macros::Type::Keybind;
+  if (!storage::set_slot(id, s)) { server.send(400, "text/plain", "id out of range"); return; }
   storage::save();
   server.send(200, "text/plain", "ok");
 }
@@ -485,7 +527,7 @@ static void handle_save_page() {
 // DELETE /api/page?id=<id>
 static void handle_delete_page(){
   if(!server.hasArg("id")){ server.send(400,"text/plain","missing id"); return; }
-  uint8_t id = (uint8_t)server.arg("id").toInt();
+  uint16_t id = (uint16_t)server.arg("id").toInt();
   auto& p = storage::profile();
   for(size_t i=0;i<p.slots.size();++i){
     if(p.slots[i].id == id){
@@ -494,7 +536,7 @@ static void handle_delete_page(){
         if(!path.startsWith("/")) path = "/" + path;
         LittleFS.remove(path);
       }
-      p.slots.erase(p.slots.begin()+i);
+      storage::remove_slot(i);
       storage::save();
       server.send(200,"text/plain","ok");
       return;
@@ -506,7 +548,7 @@ static void handle_delete_page(){
 static void handle_test() {
   String body = server.arg("plain");
   StaticJsonDocument<128> doc; if (deserializeJson(doc, body)) { server.send(400,"text/plain","bad json"); return; }
-  uint8_t id = doc["id"] | 0;
+  uint16_t id = doc["id"] | 0;
   auto s = storage::get_slot(id);
   if (!s) { server.send(404,"text/plain","no slot"); return; }
   switch (s->type) {
@@ -559,7 +601,7 @@ static void handle_icon_done(){
 static void handle_icon_upload(){
   HTTPUpload& up = server.upload();
   if (up.status == UPLOAD_FILE_START) {
-    g_upId = (uint8_t) server.arg("id").toInt();
+    g_upId = (uint16_t) server.arg("id").toInt();
     String name = up.filename; name.trim();
     int dot = name.lastIndexOf('.');
     g_upExt = (dot>=0) ? name.substring(dot) : String(".png"); // keep .png or .svg
@@ -571,8 +613,10 @@ static void handle_icon_upload(){
     if (g_upFile) g_upFile.write(up.buf, up.currentSize);
   } else if (up.status == UPLOAD_FILE_END) {
     if (g_upFile) g_upFile.close();
-    if (auto s = storage::get_slot(g_upId)) {
-      s->iconPath = String("/icons/") + g_upId + g_upExt;
+    macros::Slot s;
+    if (storage::read_slot(g_upId, s)) {
+      s.iconPath = String("/icons/") + g_upId + g_upExt;
+      storage::set_slot(g_upId, s);
       storage::save();
     }
   }
@@ -617,8 +661,260 @@ static void handle_debug(){
   server.send(200,"application/json",out);
 }
 
+static void handle_input_stats(){
+  input::Stats st = input::stats();
+  touch::Stats ts = touch::stats();
+  DynamicJsonDocument d(4096);
+  d["gestures"] = st.gestures;
+  d["delivered"] = st.delivered;
+  d["taps"] = st.taps;
+  d["double_taps"] = st.double_taps;
+  d["long_presses"] = st.long_presses;
+  d["swipes"] = st.swipes;
+  d["hardware"] = st.hardware;
+  d["suppressed"] = st.suppressed;
+  d["dropped"] = st.dropped;
+  d["last_latency_us"] = st.last_latency_us;
+  d["worst_latency_us"] = st.worst_latency_us;
+  d["touch_samples"] = ts.samples;
+  d["touch_overflows"] = ts.overflows;
+  d["touch_i2c_errors"] = ts.i2c_errors;
+  // added tap latency on slots with a double-tap action (the rest fire immediately)
+  static input::TargetStats targets[32];
+  size_t n = input::target_stats(targets, 32);
+  JsonArray arr = d.createNestedArray("slots");
+  for (size_t i = 0; i < n; ++i) {
+    int32_t idx = storage::index_of(targets[i].target);
+    if (idx < 0) continue;
+    JsonObject o = arr.createNestedObject();
+    o["index"] = idx;
+    o["taps"] = targets[i].taps;
+    o["double_taps"] = targets[i].double_taps;
+    o["window_ms"] = targets[i].window_ms;
+    o["avg_wait_us"] = targets[i].taps ? targets[i].wait_total_us / targets[i].taps : 0;
+    o["max_wait_us"] = targets[i].wait_max_us;
+  }
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+static void hist_to_json(JsonArray a, const uint32_t* h, size_t n){
+  for(size_t i=0;i<n;++i) a.add(h[i]);
+}
+
+static void handle_render_stats(){
+  render_stats::Stats st = render_stats::stats();
+  transition::Stats tr = transition::stats();
+  DynamicJsonDocument d(4096);
+  d["frames"] = st.frames;
+  d["fps"] = st.fps;
+  d["last_render_us"] = st.last_render_us;
+  d["last_flush_us"] = st.last_flush_us;
+  d["last_px"] = st.last_px;
+  d["overlay"] = render_stats::overlay();
+  JsonArray edges = d.createNestedArray("time_edges_us");
+  hist_to_json(edges, render_stats::kTimeEdgesUs, render_stats::kTimeBuckets - 1);
+  hist_to_json(d.createNestedArray("render_hist"), st.render_hist, render_stats::kTimeBuckets);
+  hist_to_json(d.createNestedArray("flush_hist"), st.flush_hist, render_stats::kTimeBuckets);
+  hist_to_json(d.createNestedArray("frame_hist"), st.frame_hist, render_stats::kTimeBuckets);
+  hist_to_json(d.createNestedArray("area_hist"), st.area_hist, render_stats::kAreaBuckets);  // <1,<10,<25,<50,<100 %, full
+  static render_stats::PageStats pages[render_stats::kMaxPages];
+  size_t n = render_stats::page_stats(pages, render_stats::kMaxPages);
+  JsonArray pa = d.createNestedArray("pages");   // index 0 = clock
+  for(size_t i=0;i<n;++i){
+    if(!pages[i].frames) continue;
+    JsonObject o = pa.createNestedObject();
+    o["page"] = i;
+    o["frames"] = pages[i].frames;
+    o["over_budget"] = pages[i].over_budget;
+    o["worst_us"] = pages[i].worst_us;
+    o["heap_peak"] = pages[i].heap_peak;
+  }
+  JsonObject t = d.createNestedObject("transitions");
+  t["runs"] = tr.runs; t["frames"] = tr.frames; t["dropped"] = tr.dropped;
+  t["last_ms"] = tr.last_ms; t["worst_frame_us"] = tr.worst_frame_us;
+  gradient::Stats gs = gradient::stats();
+  JsonObject g = d.createNestedObject("gradients");
+  g["built"] = gs.built; g["shared"] = gs.shared; g["in_use"] = gs.in_use;
+  style_pool::Stats ss = style_pool::stats();
+  JsonObject sty = d.createNestedObject("styles");
+  sty["shared"] = ss.styles; sty["objects"] = ss.attached; sty["bytes_saved"] = ss.bytes_saved;
+  lvgl_mem_stats_t ms = lvgl_mem_stats();
+  JsonObject m = d.createNestedObject("lvgl_mem");
+  JsonObject mi = m.createNestedObject("internal");
+  mi["budget"] = ms.arena_bytes; mi["pages_bytes"] = ms.arena_used;
+  mi["used"] = ms.small_bytes; mi["blocks"] = ms.small_blocks; mi["frag_pct"] = ms.frag_pct;
+  JsonObject mp = m.createNestedObject("psram");
+  mp["used"] = ms.large_bytes; mp["blocks"] = ms.large_blocks; mp["peak"] = ms.large_peak;
+  m["fallbacks"] = ms.fallbacks;
+  splash::Stats sp = splash::stats();
+  JsonObject s = d.createNestedObject("splash");
+  s["saves"] = sp.saves; s["skipped"] = sp.skipped; s["last_bytes"] = sp.last_bytes;
+  s["last_save_ms"] = sp.last_save_ms; s["boot_show_ms"] = sp.boot_show_ms;
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+// GET /api/cpu: idle share per core and how often the LVGL task wakes
+static void handle_cpu(){
+  StaticJsonDocument<256> d;
+  JsonArray idle = d.createNestedArray("idle_pct");   // last full second, per core
+  for(uint8_t c=0;c<cpu_load::cores();++c) idle.add(cpu_load::idle_pct(c));
+  ui::LoopStats ls = ui::loop_stats();
+  JsonObject l = d.createNestedObject("lvgl");
+  l["passes"] = ls.passes;
+  l["early_wakes"] = ls.early_wakes;
+  l["last_sleep_ms"] = (int32_t)ls.last_sleep_ms;   // -1: sleeping until woken
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+// GET /api/boot: per-phase timeline (ms since reset) and time to the first usable tap
+static void handle_boot(){
+  StaticJsonDocument<1024> d;
+  JsonArray ph = d.createNestedArray("phases");
+  uint32_t last = 0;
+  for(uint8_t i=0;i<(uint8_t)boot::Phase::Count;++i){
+    const boot::Phase p = (boot::Phase)i;
+    boot::Record r = boot::record(p);
+    JsonObject o = ph.createNestedObject();
+    o["name"] = boot::name(p);
+    o["core"] = r.core;
+    if(r.core < 0) continue;
+    o["start_ms"] = r.start_ms; o["end_ms"] = r.end_ms; o["ms"] = r.end_ms - r.start_ms;
+    o["ok"] = r.ok;
+    if(r.end_ms > last) last = r.end_ms;
+  }
+  d["usable_ms"] = boot::usable_ms();        // UI built and BLE up
+  d["first_tap_ms"] = boot::first_tap_ms();  // 0: none yet
+  d["done_ms"] = last;
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+// GET /api/coex: Wi-Fi power state and, per state, how long HID notify() took to queue a report in the BLE host
+// POST /api/coex {"idle_s":60,"down_s":600,"ble_idle_s":30} (any subset; down_s 0 = never)
+static void handle_coex_get(){
+  StaticJsonDocument<768> d;
+  coex::Config c = coex::config();
+  d["state"] = coex::state_name(coex::state());
+  d["transitions"] = coex::transitions();
+  d["idle_s"] = c.idle_after_s; d["down_s"] = c.down_after_s; d["ble_idle_s"] = c.ble_idle_s;
+  JsonObject j = d.createNestedObject("notify_host_us");
+  for(uint8_t i=0;i<(uint8_t)coex::State::Count;++i){
+    coex::NotifyCost jt = coex::notify_cost((coex::State)i);
+    JsonObject o = j.createNestedObject(coex::state_name((coex::State)i));
+    o["count"] = jt.count; o["mean"] = jt.mean_us; o["stddev"] = jt.stddev_us; o["max"] = jt.max_us;
+  }
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+static void handle_coex_set(){
+  StaticJsonDocument<128> doc;
+  if(deserializeJson(doc, server.arg("plain"))){ server.send(400,"text/plain","bad json"); return; }
+  coex::Config c = coex::config();
+  c.idle_after_s = doc["idle_s"] | c.idle_after_s;
+  c.down_after_s = doc["down_s"] | c.down_after_s;
+  c.ble_idle_s = doc["ble_idle_s"] | c.ble_idle_s;
+  coex::configure(c);
+  handle_coex_get();
+}
+
+// GET /api/power: timeouts, state and transition timings
+// POST /api/power {"dim_s":60,"off_s":300,"level":16,"dim_level":3} (any subset; 0 s = never)
+static void send_power(const power::Config& c){
+  power::Stats st = power::stats();
+  StaticJsonDocument<512> d;
+  d["dim_s"] = c.dim_after_s; d["off_s"] = c.off_after_s;
+  d["level"] = c.level; d["dim_level"] = c.dim_level;
+  d["state"] = power::state_name(st.state);
+  d["dims"] = st.dims; d["sleeps"] = st.sleeps; d["wakes"] = st.wakes;
+  d["last_dim_us"] = st.last_dim_us;
+  d["last_sleep_us"] = st.last_sleep_us;
+  d["last_wake_us"] = st.last_wake_us;
+  d["last_wake_latency_us"] = st.last_latency_us;
+  d["worst_wake_latency_us"] = st.worst_latency_us;
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+static void handle_power_get(){ send_power(power::config()); }
+
+static void handle_power_set(){
+  StaticJsonDocument<128> doc;
+  if(deserializeJson(doc, server.arg("plain"))){ server.send(400,"text/plain","bad json"); return; }
+  power::Config c = power::config();
+  c.dim_after_s = constrain((long)(doc["dim_s"] | (long)c.dim_after_s), 0L, 65535L);
+  c.off_after_s = constrain((long)(doc["off_s"] | (long)c.off_after_s), 0L, 65535L);
+  c.level = constrain((int)(doc["level"] | (int)c.level), 1, 16);
+  c.dim_level = constrain((int)(doc["dim_level"] | (int)c.dim_level), 1, 16);
+  ui::set_power(c);   // applied on the LVGL task, which also owns the backlight
+  send_power(c);
+}
+
+// GET /api/net: when Wi-Fi starts at boot, how long the AP outlives a station link
+// POST /api/net {"start":"background"|"on_demand","ap_grace_s":120} (any subset; start: next boot,
+// on_demand: long press the clock page; ap_grace_s 0: keep the AP)
+static void handle_net_get(){
+  StaticJsonDocument<128> d;
+  net::Config c = net::config();
+  d["start"] = net::start_name(c.start);
+  d["ap_grace_s"] = c.ap_grace_s;
+  d["sta"] = net::sta_ok();
+  d["ap"] = net::ap_running();
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
+static void handle_net_set(){
+  StaticJsonDocument<96> doc;
+  if(deserializeJson(doc, server.arg("plain"))){ server.send(400,"text/plain","bad json"); return; }
+  net::Config c = net::config();
+  if(doc.containsKey("start")){
+    const char* s = doc["start"] | "";
+    if(strcmp(s,"background") && strcmp(s,"on_demand")){ server.send(400,"text/plain","start: background|on_demand"); return; }
+    c.start = strcmp(s,"on_demand") ? net::Start::Background : net::Start::OnDemand;
+  }
+  c.ap_grace_s = doc["ap_grace_s"] | c.ap_grace_s;
+  net::configure(c);
+  handle_net_get();
+}
+
+// POST /api/render-overlay {"on":true}
+static void handle_render_overlay(){
+  StaticJsonDocument<64> doc;
+  if(deserializeJson(doc, server.arg("plain"))){ server.send(400,"text/plain","bad json"); return; }
+  bool on = doc["on"] | !render_stats::overlay();
+  ui::render_overlay(on);
+  server.send(200,"text/plain", on ? "on" : "off");
+}
+
+// Raw touch traces for tools/trace_replay. Name the trace after what was
+// performed (tap_1, swipe_left_3, ...); the tool uses the prefix as the label.
+static void handle_trace_start(){
+  if(!touch::record_start()){ server.send(500,"text/plain","no memory"); return; }
+  server.send(200,"text/plain","recording");
+}
+
+static void handle_trace_stop(){
+  String name = server.arg("name");
+  if(!name.length()) name = "trace";
+  for(size_t i=0;i<name.length();++i){
+    char c = name[i];
+    if(!isalnum((unsigned char)c) && c!='_' && c!='-'){ server.send(400,"text/plain","bad name"); return; }
+  }
+  LittleFS.mkdir("/traces");
+  String path = "/traces/" + name + ".ktr";
+  int n = touch::record_stop(path.c_str());
+  if(n < 0){ server.send(409,"text/plain","not recording"); return; }
+  StaticJsonDocument<128> d;
+  d["path"] = path; d["samples"] = n;
+  String out; serializeJson(d,out);
+  server.send(200,"application/json",out);
+}
+
 static void handle_factory(){
-  LittleFS.begin(true);
   LittleFS.remove("/config/wifi.json");
   LittleFS.remove("/macros/slots.json");
   if (LittleFS.exists("/icons")) rmrf("/icons");
@@ -635,6 +931,7 @@ static void handle_clearbonds(){
 }
 
 bool web::begin() {
+  server.addHandler(new ActivityTap());
   server.on("/", HTTP_GET, handle_index);
   server.on("/api/pages", HTTP_GET, handle_pages);
   server.on("/api/page", HTTP_POST, handle_save_page);
@@ -653,10 +950,23 @@ bool web::begin() {
   server.on("/api/factory_reset", HTTP_POST, handle_factory);
   server.on("/api/clearbonds", HTTP_POST, handle_clearbonds);
   server.on("/debug", HTTP_GET, handle_debug);
+  server.on("/api/input", HTTP_GET, handle_input_stats);
+  server.on("/api/render-stats", HTTP_GET, handle_render_stats);
+  server.on("/api/render-overlay", HTTP_POST, handle_render_overlay);
+  server.on("/api/cpu", HTTP_GET, handle_cpu);
+  server.on("/api/boot", HTTP_GET, handle_boot);
+  server.on("/api/net", HTTP_GET, handle_net_get);
+  server.on("/api/net", HTTP_POST, handle_net_set);
+  server.on("/api/coex", HTTP_GET, handle_coex_get);
+  server.on("/api/coex", HTTP_POST, handle_coex_set);
+  server.on("/api/power", HTTP_GET, handle_power_get);
+  server.on("/api/power", HTTP_POST, handle_power_set);
+  server.on("/api/trace/start", HTTP_POST, handle_trace_start);
+  server.on("/api/trace/stop", HTTP_POST, handle_trace_stop);
   server.onNotFound([](){
     if (server.method() == HTTP_OPTIONS) { server.send(204); return; }
     String u = server.uri();
-    if(u.startsWith("/icons/")) { serveIconFile(); return; }
+    if(u.startsWith("/icons/") || u.startsWith("/traces/")) { serveIconFile(); return; }
     server.sendHeader("Cache-Control","no-store, no-cache, must-revalidate, max-age=0");
     server.send_P(200, "text/html; charset=utf-8", INDEX_HTML);
   });
@@ -1,74 +1,207 @@
 #include "widgets.hpp"
+#include "gradient.hpp"
+#include "style_pool.hpp"
 #include "ble_hid.hpp"
+#include "coex.hpp"
 #include <time.h>
+extern "C" {
+  #include "esp_heap_caps.h"
+}
 
 namespace {
 
+const lv_font_t* clock_font(){
+#if LV_FONT_MONTSERRAT_48
+  return &lv_font_montserrat_48;
+#else
+  return LV_FONT_DEFAULT;
+#endif
+}
+
+// The clock face's digits and colon, rendered once from the 48 px font and cropped
+// to their ink rows. Digits share one cell width so the time never shifts sideways;
+// the colon is also cropped to its columns, so blinking it invalidates only that box.
+// Images are opaque (white on black), so LVGL draws nothing underneath them.
+struct ClockGlyphs {
+  lv_img_dsc_t digit[10];
+  lv_img_dsc_t colon;
+  lv_coord_t line_h = 0;     // font line height the crops were taken from
+  lv_coord_t digit_y = 0;    // first ink row of the digits in that line
+  lv_coord_t colon_y = 0;
+  bool ready = false;
+};
+ClockGlyphs g_glyphs;
+
+// One character centred in a w x h cell, white on black; nullptr when out of memory.
+lv_color_t* render_cell(lv_obj_t* parent, const char* text, lv_coord_t w, lv_coord_t h){
+  lv_obj_t* l = lv_label_create(parent);
+  lv_obj_set_style_text_font(l, clock_font(), 0);
+  lv_obj_set_style_text_color(l, lv_color_white(), 0);
+  lv_obj_set_style_text_align(l, LV_TEXT_ALIGN_CENTER, 0);
+  lv_label_set_text_static(l, text);
+  lv_obj_set_size(l, w, h);
+  lv_obj_update_layout(l);
+  const uint32_t size = lv_snapshot_buf_size_needed(l, LV_IMG_CF_TRUE_COLOR);
+  lv_color_t* buf = size == (uint32_t)(w * h * sizeof(lv_color_t)) ? (lv_color_t*)malloc(size) : nullptr;
+  lv_img_dsc_t dsc;
+  if(buf && lv_snapshot_take_to_buf(l, LV_IMG_CF_TRUE_COLOR, &dsc, buf, size) != LV_RES_OK){ free(buf); buf = nullptr; }
+  lv_obj_del(l);
+  return buf;
+}
+
+bool ink(const lv_color_t* px, int n){
+  for(int i = 0; i < n; ++i) if(px[i].full) return true;
+  return false;
+}
+
+void build_glyphs(lv_obj_t* parent){
+  static const char* const kChars[11] = {"0","1","2","3","4","5","6","7","8","9",":"};
+  const lv_font_t* f = clock_font();
+  const lv_coord_t h = lv_font_get_line_height(f);
+  lv_coord_t cw = 0;
+  for(uint32_t c = '0'; c <= '9'; ++c) cw = LV_MAX(cw, (lv_coord_t)lv_font_get_glyph_width(f, c, 0));
+  const lv_coord_t colw = lv_font_get_glyph_width(f, ':', 0);
+
+  lv_color_t* cell[11] = {};
+  bool ok = true;
+  for(int i = 0; i < 11 && ok; ++i) ok = (cell[i] = render_cell(parent, kChars[i], i < 10 ? cw : colw, h)) != nullptr;
+
+  // ink bounds: rows shared by all digits, rows and columns of the colon
+  int dy0 = h, dy1 = 0, cy0 = h, cy1 = 0, cx0 = colw, cx1 = 0;
+  for(int i = 0; i < 10 && ok; ++i)
+    for(int y = 0; y < h; ++y) if(ink(cell[i] + y * cw, cw)){ dy0 = LV_MIN(dy0, y); dy1 = LV_MAX(dy1, y + 1); }
+  for(int y = 0; y < h && ok; ++y)
+    for(int x = 0; x < colw; ++x) if(cell[10][y * colw + x].full){
+      cy0 = LV_MIN(cy0, y); cy1 = LV_MAX(cy1, y + 1);
+      cx0 = LV_MIN(cx0, x); cx1 = LV_MAX(cx1, x + 1);
+    }
+  ok = ok && dy1 > dy0 && cy1 > cy0 && cx1 > cx0;
+
+  const int dh = dy1 - dy0, ch = cy1 - cy0, ccw = cx1 - cx0;
+  const size_t bytes = ok ? (10 * cw * dh + ccw * ch) * sizeof(lv_color_t) : 0;
+  lv_color_t* pool = nullptr;
+  if(bytes){
+    pool = (lv_color_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if(!pool) pool = (lv_color_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+  if(pool){
+    auto describe = [](lv_img_dsc_t& d, const lv_color_t* data, int w, int h){
+      memset(&d, 0, sizeof(d));
+      d.header.always_zero = 0;
+      d.header.cf = LV_IMG_CF_TRUE_COLOR;
+      d.header.w = w;
+      d.header.h = h;
+      d.data_size = w * h * sizeof(lv_color_t);
+      d.data = (const uint8_t*)data;
+    };
+    lv_color_t* p = pool;
+    for(int i = 0; i < 10; ++i){
+      memcpy(p, cell[i] + dy0 * cw, cw * dh * sizeof(lv_color_t));
+      describe(g_glyphs.digit[i], p, cw, dh);
+      p += cw * dh;
+    }
+    for(int y = 0; y < ch; ++y) memcpy(p + y * ccw, cell[10] + (cy0 + y) * colw + cx0, ccw * sizeof(lv_color_t));
+    describe(g_glyphs.colon, p, ccw, ch);
+    g_glyphs.line_h = h;
+    g_glyphs.digit_y = dy0;
+    g_glyphs.colon_y = cy0;
+    g_glyphs.ready = true;
+  }
+  for(auto c : cell) free(c);
+}
+
 struct ClockWidget : public widgets::Widget {
+  static constexpr lv_coord_t kTimeY = -6;   // centre of the time line, from the screen centre
+  static constexpr lv_coord_t kGap   = 4;    // either side of the colon
+
   lv_obj_t* cont{nullptr};
-  lv_obj_t* timeLbl{nullptr};
+  lv_obj_t* timeBox{nullptr};                // digit and colon images, when the glyphs were built
+  lv_obj_t* digits[4]{};
+  lv_obj_t* colon{nullptr};
+  lv_obj_t* timeLbl{nullptr};                // fallback without glyph memory
   lv_obj_t* dateLbl{nullptr};
   bool blinkOn{true};
-  time_t lastShown{0};
+  struct tm tm{};                            // local time of the minute on screen
+  time_t minStart{-1};                       // local epoch of that minute
+  int dateKey{-1};                           // tm_year * 400 + tm_yday of the date on screen
+  int8_t shown[4]{-1, -1, -1, -1};
 
   ClockWidget(lv_obj_t* parent){
     cont = lv_obj_create(parent);
     lv_obj_set_size(cont, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_bg_color(cont, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(cont, LV_OPA_COVER, 0);
-    lv_obj_set_style_pad_all(cont, 0, 0);
+    style_pool::attach(cont, style_pool::clock_page());
     lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_scrollbar_mode(cont, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_border_width(cont, 0, 0);
 
-    timeLbl = lv_label_create(cont);
-    lv_label_set_text(timeLbl, "--:--");
-#if LV_FONT_MONTSERRAT_48
-    lv_obj_set_style_text_font(timeLbl, &lv_font_montserrat_48, 0);
-#endif
-    lv_obj_set_style_text_color(timeLbl, lv_color_white(), 0);
-    lv_obj_set_style_text_letter_space(timeLbl, 1, 0);
-    lv_obj_align(timeLbl, LV_ALIGN_CENTER, 0, -6);
+    if(!g_glyphs.ready) build_glyphs(cont);
+    if(g_glyphs.ready){
+      const lv_img_dsc_t& d0 = g_glyphs.digit[0];
+      const lv_coord_t cw = d0.header.w, dh = d0.header.h, colw = g_glyphs.colon.header.w;
+      timeBox = lv_obj_create(cont);
+      lv_obj_remove_style_all(timeBox);
+      lv_obj_clear_flag(timeBox, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+      lv_obj_set_size(timeBox, 4 * cw + colw + 2 * kGap, dh);
+      lv_obj_align(timeBox, LV_ALIGN_CENTER, 0, kTimeY - g_glyphs.line_h / 2 + g_glyphs.digit_y + dh / 2);
+      for(int i = 0; i < 4; ++i){
+        digits[i] = lv_img_create(timeBox);
+        lv_obj_set_pos(digits[i], i * cw + (i >= 2 ? colw + 2 * kGap : 0), 0);
+      }
+      colon = lv_img_create(timeBox);
+      lv_img_set_src(colon, &g_glyphs.colon);
+      lv_obj_set_pos(colon, 2 * cw + kGap, g_glyphs.colon_y - g_glyphs.digit_y);
+    }else{
+      timeLbl = lv_label_create(cont);
+      lv_label_set_text(timeLbl, "--:--");
+      style_pool::attach(timeLbl, style_pool::clock_label());
+      lv_obj_set_style_text_font(timeLbl, clock_font(), 0);
+      lv_obj_set_style_text_letter_space(timeLbl, 1, 0);
+      lv_obj_align(timeLbl, LV_ALIGN_CENTER, 0, kTimeY);
+    }
 
     dateLbl = lv_label_create(cont);
     lv_label_set_text(dateLbl, "Sun, 01 Jan 1970");
-#if LV_FONT_MONTSERRAT_22
-    lv_obj_set_style_text_font(dateLbl, &lv_font_montserrat_22, 0);
-#endif
-    lv_obj_set_style_text_color(dateLbl, lv_color_white(), 0);
+    style_pool::attach(dateLbl, style_pool::clock_label());
     lv_obj_align(dateLbl, LV_ALIGN_CENTER, 0, 36);
   }
 
+  // Move tm to the minute holding local time t. The next minute is a couple of
+  // increments; only a new day or a clock change goes through gmtime_r.
+  void advance(time_t t){
+    if(minStart >= 0 && t >= minStart && t < minStart + 60) return;   // first call always formats
+    if(minStart >= 0 && t >= minStart + 60 && t < minStart + 120){
+      minStart += 60;
+      if(++tm.tm_min < 60) return;
+      tm.tm_min = 0;
+      if(++tm.tm_hour < 24) return;
+    }
+    gmtime_r(&t, &tm);
+    minStart = t - tm.tm_sec;
+  }
+
+  // Touches only what changed: a digit image per changed digit, the colon's box, the date once a day.
   void refresh(){
-    time_t now = time(nullptr);
-    if(now != lastShown){
-      lastShown = now;
-      char buf[64];
-      rtime::format(buf, sizeof(buf), "%H:%M", "%a, %d %b %Y");
-      const char* nl = strchr(buf, '\n');
-      String timeStr, dateStr;
-      if(nl){ timeStr = String(buf, nl - buf); dateStr = String(nl + 1); }
-      else  { timeStr = String(buf); dateStr = ""; }
-
-      if(!blinkOn){
-        int c = timeStr.indexOf(':');
-        if(c >= 0) timeStr.setCharAt(c, ' ');
+    advance(rtime::local_now());
+    const int8_t d[4] = {(int8_t)(tm.tm_hour / 10), (int8_t)(tm.tm_hour % 10), (int8_t)(tm.tm_min / 10), (int8_t)(tm.tm_min % 10)};
+    if(timeBox){
+      for(int i = 0; i < 4; ++i){
+        if(d[i] == shown[i]) continue;
+        shown[i] = d[i];
+        lv_img_set_src(digits[i], &g_glyphs.digit[d[i]]);
       }
-
-      lv_label_set_text(timeLbl, timeStr.c_str());
-      if(dateStr.length()) lv_label_set_text(dateLbl, dateStr.c_str());
-    }else{
-      const char* cur = lv_label_get_text(timeLbl);
-      if(!cur) return;
-      String timeStr(cur);
-      if(!blinkOn){
-        int c = timeStr.indexOf(':');
-        if(c >= 0) timeStr.setCharAt(c, ' ');
-      }else{
-        int c = timeStr.indexOf(' ');
-        if(c >= 0) timeStr.setCharAt(c, ':');
+      if(blinkOn == lv_obj_has_flag(colon, LV_OBJ_FLAG_HIDDEN)){
+        if(blinkOn) lv_obj_clear_flag(colon, LV_OBJ_FLAG_HIDDEN);
+        else        lv_obj_add_flag(colon, LV_OBJ_FLAG_HIDDEN);
       }
-      lv_label_set_text(timeLbl, timeStr.c_str());
+    }else{
+      lv_label_set_text_fmt(timeLbl, "%d%d%c%d%d", d[0], d[1], blinkOn ? ':' : ' ', d[2], d[3]);
+    }
+
+    const int key = tm.tm_year * 400 + tm.tm_yday;
+    if(key != dateKey){
+      dateKey = key;
+      char buf[32];
+      strftime(buf, sizeof(buf), "%a, %d %b %Y", &tm);
+      lv_label_set_text(dateLbl, buf);
     }
   }
 
@@ -80,42 +213,38 @@ struct ClockWidget : public widgets::Widget {
     blinkOn = !blinkOn;
     refresh();
   }
+  // The clock is the settings entry: a long press brings Wi-Fi (AP + web UI) up if it isn't
+  void onInput(const gesture::Event& ev) override {
+    if(ev.kind == gesture::Kind::LongPress) coex::wake();
+  }
 };
 
 struct MacroWidget : public widgets::Widget {
   lv_obj_t* cont{nullptr};
   lv_obj_t* img{nullptr};
   lv_obj_t* tapDot { nullptr };
-  macros::Slot* slot{nullptr};
-  bool pressed = false;
-  bool moved   = false;
-  lv_point_t press_pt{};
-  uint32_t press_tick = 0;
-  uint32_t swipe_lock_until = 0;
+  macros::Slot slot;   // own copy: the profile vector may reallocate under us
+  String heldPayload;  // combo currently held down for a Trigger::Hold page
+  const gradient::Table* grad = nullptr;   // row table painting the background, when bg != bg2
+  lv_style_t* look = nullptr;              // shared background style (style_pool)
   uint16_t baseZoom = 256;
   uint16_t curZoom  = 256;
 
-  MacroWidget(lv_obj_t* parent, macros::Slot* s): slot(s){
+  MacroWidget(lv_obj_t* parent, const macros::Slot& s): slot(s){
     cont = lv_obj_create(parent);
     lv_obj_set_size(cont, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_bg_opa(cont, LV_OPA_COVER, 0);
-    lv_obj_set_style_pad_all(cont, 0, 0);
     lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_scrollbar_mode(cont, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_border_width(cont, 0, 0);
     tapDot = lv_obj_create(cont);
     lv_obj_set_size(tapDot, 14, 14);
-    lv_obj_set_style_radius(tapDot, LV_RADIUS_CIRCLE, 0);
-    lv_obj_set_style_bg_color(tapDot, lv_color_white(), 0);
-    lv_obj_set_style_bg_opa(tapDot, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(tapDot, 0, 0);
+    style_pool::attach(tapDot, style_pool::tap_dot());
     lv_obj_add_flag(tapDot, LV_OBJ_FLAG_HIDDEN);
     // position at top-center, 10px down
     lv_obj_align(tapDot, LV_ALIGN_TOP_MID, 0, 10);
 
     img = lv_img_create(cont);
 
-    lv_obj_add_flag(cont, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
+    lv_obj_add_flag(cont, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_add_event_cb(cont, [](lv_event_t* e){
       auto self = (MacroWidget*)lv_event_get_user_data(e);
       auto code = lv_event_get_code(e);
@@ -128,52 +257,13 @@ struct MacroWidget : public widgets::Widget {
         lv_obj_add_flag(self->tapDot, LV_OBJ_FLAG_HIDDEN);
       };
 
-      // Treat any gesture as a swipe; lock out taps briefly
-      if(code == LV_EVENT_GESTURE){
-        self->moved = true;
-        self->swipe_lock_until = lv_tick_get() + 250; // 250ms lockout after swipe
-        hideDot();
-        return;
-      }
-
-      if(code == LV_EVENT_PRESSED){
-        self->pressed = true; self->moved = false;
-        self->press_tick = lv_tick_get();
-        lv_indev_get_point(lv_indev_get_act(), &self->press_pt);
-        showDot();               // instant visual on press
-        return;
-      }
-
-      if(code == LV_EVENT_PRESSING){
-        lv_point_t p; lv_indev_get_point(lv_indev_get_act(), &p);
-        const int dx = p.x - self->press_pt.x;
-        const int dy = p.y - self->press_pt.y;
-        // Early, strict swipe detection:
-        // if finger moves >10px OR horizontal bias (|dx| > |dy|+4) with >8px, cancel tap
-        if (LV_ABS(dx) > 10 || LV_ABS(dy) > 10 || (LV_ABS(dx) > LV_ABS(dy)+4 && LV_ABS(dx) > 8)) {
-          self->moved = true;
-          self->swipe_lock_until = lv_tick_get() + 250;
-          hideDot();
-        }
-        return;
-      }
-
-      if(code == LV_EVENT_RELEASED){
-        uint32_t now = lv_tick_get();
-        // If we just swiped or moved too much, or within lockout, ignore tap
-        if(now < self->swipe_lock_until || self->moved){
-          self->pressed=false; self->moved=false; hideDot(); return;
-        }
-        // Valid quick tap (avoid long holds >700ms)
-        if(self->pressed && (now - self->press_tick) < 700){
-          hideDot();
-          self->onTap();   // enqueue macro (async)
-        } else {
-          hideDot();
-        }
-        self->pressed=false; self->moved=false;
-        return;
-      }
+      // Visual feedback only; taps and swipes are recognized by the UI's gesture pipeline
+      if(code == LV_EVENT_PRESSED) showDot();
+      else if(code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST) hideDot();
+    }, LV_EVENT_ALL, this);
+    lv_obj_add_event_cb(cont, [](lv_event_t* e){
+      auto self = (MacroWidget*)lv_event_get_user_data(e);
+      if(self->grad) gradient::paint(e, self->grad);
     }, LV_EVENT_ALL, this);
 
     // Start with sane zoom and center
@@ -185,20 +275,24 @@ struct MacroWidget : public widgets::Widget {
   }
 
   void applyStyle(){
-    // Always gradient; if bg==bg2, looks solid
-    lv_obj_set_style_bg_color(cont, lv_color_make((slot->bg>>16)&255,(slot->bg>>8)&255,slot->bg&255), 0);
-    if(slot->bg2 != slot->bg){
-      lv_obj_set_style_bg_grad_dir(cont, LV_GRAD_DIR_VER, 0);
-      lv_color_t c2 = lv_color_make((slot->bg2>>16)&255,(slot->bg2>>8)&255,slot->bg2&255);
-      lv_obj_set_style_bg_grad_color(cont, c2, 0);
-    }else{
-      lv_obj_set_style_bg_grad_dir(cont, LV_GRAD_DIR_NONE, 0);
+    // Always gradient; if bg==bg2, looks solid. Gradients are painted from a shared
+    // row table (gradient.hpp); LVGL's own gradient is only the fallback. Pages with
+    // the same colours share one style (style_pool.hpp).
+    const gradient::Table* t = slot.bg2 != slot.bg ? gradient::acquire(slot.bg, slot.bg2) : nullptr;
+    gradient::release(grad);
+    grad = t;
+    lv_style_t* s = style_pool::page(slot.bg, slot.bg2, grad != nullptr);
+    if(s != look){
+      style_pool::attach(cont, s);
+      if(look) style_pool::detach(cont, look);
+      look = s;
     }
+    lv_obj_invalidate(cont);
   }
 
   void applyIcon(){
-    if(slot->iconPath.length()){
-      String p = slot->iconPath; if (p.startsWith("/")) p.remove(0,1);
+    if(slot.iconPath.length()){
+      String p = slot.iconPath; if (p.startsWith("/")) p.remove(0,1);
       String fsPath = String("L:") + p;
 
       // Get real image size from decoder (so pivot centers correctly)
@@ -235,12 +329,44 @@ struct MacroWidget : public widgets::Widget {
 
 
   lv_obj_t* root() override { return cont; }
-  void show() override { lv_obj_clear_flag(cont, LV_OBJ_FLAG_HIDDEN); applyStyle(); applyIcon(); lv_obj_center(img); }
+  void show() override { lv_obj_clear_flag(cont, LV_OBJ_FLAG_HIDDEN); lv_obj_center(img); }
   void hide() override { lv_obj_add_flag(cont, LV_OBJ_FLAG_HIDDEN); }
+  void bind(const macros::Slot& s) override {
+    endHold();   // recycled or edited mid-hold: don't leave the key down
+    slot = s; applyStyle(); applyIcon();
+  }
   void onTap() override {
     Serial.println("[UI] tap on MacroWidget");
-    if(!slot) return;
-    macros::enqueue(slot->type, slot->payload);   // run in background task
+    macros::enqueue(slot.type, slot.payload);   // run in background task
+  }
+  void onInput(const gesture::Event& ev) override {
+    using gesture::Kind;
+    if(ev.kind == Kind::DoubleTap && slot.doubleTap.set()){ fire(slot.doubleTap); return; }
+    if(ev.kind == Kind::LongPress){ if(slot.longPress.set()) fire(slot.longPress); return; }
+    switch(slot.trigger){
+      case macros::Trigger::Release:
+        if(ev.kind == Kind::Tap || ev.kind == Kind::DoubleTap) onTap();
+        break;
+      case macros::Trigger::Press:
+        if(ev.kind == Kind::Press) onTap();
+        break;
+      case macros::Trigger::Hold:
+        if(ev.kind == Kind::Release){ endHold(); break; }
+        if(ev.kind != Kind::Press) break;
+        if(!macros::can_hold(slot.type, slot.payload)){ onTap(); break; }
+        heldPayload = slot.payload;
+        macros::enqueue_hold(heldPayload, true);
+        break;
+    }
+  }
+  void fire(const macros::Binding& b){
+    Serial.println("[UI] secondary binding on MacroWidget");
+    macros::enqueue(b.type, b.payload);
+  }
+  void endHold(){
+    if(!heldPayload.length()) return;
+    macros::enqueue_hold(heldPayload, false);
+    heldPayload = String();
   }
 };
 
@@ -249,6 +375,6 @@ struct MacroWidget : public widgets::Widget {
 namespace widgets {
 
 Widget* createClock(lv_obj_t* parent){ return new ClockWidget(parent); }
-Widget* createMacro(lv_obj_t* parent, macros::Slot* slot){ return new MacroWidget(parent, slot); }
+Widget* createMacro(lv_obj_t* parent, const macros::Slot& slot){ return new MacroWidget(parent, slot); }
 
 } // namespace widgets
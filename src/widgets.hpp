@@ -3,6 +3,7 @@
 #include "storage.hpp"
 #include "rtc_time.hpp"
 #include "macros.hpp"
+#include "gesture.hpp"
 
 namespace widgets {
 
@@ -13,9 +14,14 @@ struct Widget {
   virtual void hide() = 0;              // hide
   virtual void tick(uint32_t /*ms*/) {} // called each second
   virtual void onTap() {}               // tap on page
+  // every non-swipe gesture on the visible page, once; the controller's double click is its second tap
+  virtual void onInput(const gesture::Event& ev) {
+    if(ev.kind == gesture::Kind::Tap || ev.kind == gesture::Kind::DoubleTap) onTap();
+  }
+  virtual void bind(const macros::Slot&) {} // (re)bind to a copy of slot data
 };
 
 Widget* createClock(lv_obj_t* parent);
-Widget* createMacro(lv_obj_t* parent, macros::Slot* slot);
+Widget* createMacro(lv_obj_t* parent, const macros::Slot& slot);
 
 } // namespace widgets
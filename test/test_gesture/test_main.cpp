@@ -0,0 +1,80 @@
+// Host tests for gesture::Recognizer:  pio test -e test
+#include <unity.h>
+#include <vector>
+#include "gesture.hpp"
+
+using gesture::Kind;
+
+namespace {
+
+constexpr uint8_t HW_SWIPE_LEFT = 0x03;
+constexpr uint8_t HW_CLICK      = 0x05;
+
+touch::Sample at(uint32_t ms, uint16_t x, uint16_t y, bool down, uint8_t g = 0) {
+  return touch::Sample{ ms * 1000, x, y, g, down };
+}
+
+std::vector<Kind> run(gesture::Recognizer& rec, const std::vector<touch::Sample>& samples, uint32_t until_ms) {
+  std::vector<Kind> out;
+  gesture::Event ev;
+  for (const auto& s : samples) {
+    rec.feed(s);
+    while (rec.next(ev)) out.push_back(ev.kind);
+  }
+  rec.poll(until_ms * 1000);
+  while (rec.next(ev)) out.push_back(ev.kind);
+  return out;
+}
+
+void expect(const std::vector<Kind>& want, const std::vector<Kind>& got) {
+  TEST_ASSERT_EQUAL_UINT32(want.size(), got.size());
+  for (size_t i = 0; i < want.size(); ++i) TEST_ASSERT_EQUAL_UINT8((uint8_t)want[i], (uint8_t)got[i]);
+}
+
+} // anon
+
+void test_tap_then_late_click_id() {
+  gesture::Recognizer rec;
+  auto got = run(rec, { at(0, 120, 120, true), at(80, 120, 120, false),
+                        at(110, 120, 120, false, HW_CLICK) }, 1000);
+  expect({ Kind::Press, Kind::Tap, Kind::Release }, got);
+  TEST_ASSERT_EQUAL_UINT32(1, rec.gestures());
+  TEST_ASSERT_EQUAL_UINT32(1, rec.suppressed());
+}
+
+void test_tap_then_late_click_id_with_double_tap_window() {
+  gesture::Config cfg;
+  cfg.double_tap_ms = 250;
+  gesture::Recognizer rec(cfg);
+  auto got = run(rec, { at(0, 120, 120, true), at(80, 120, 120, false),
+                        at(110, 120, 120, false, HW_CLICK) }, 1000);
+  expect({ Kind::Press, Kind::Release, Kind::Tap }, got);
+  TEST_ASSERT_EQUAL_UINT32(1, rec.suppressed());
+}
+
+void test_swipe_then_late_swipe_id() {
+  gesture::Recognizer rec;
+  auto got = run(rec, { at(0, 200, 120, true), at(20, 170, 120, true), at(40, 120, 120, true),
+                        at(60, 100, 120, false), at(90, 100, 120, false, HW_SWIPE_LEFT) }, 1000);
+  expect({ Kind::Press, Kind::SwipeLeft, Kind::Release }, got);
+  TEST_ASSERT_EQUAL_UINT32(1, rec.gestures());
+  TEST_ASSERT_EQUAL_UINT32(1, rec.suppressed());
+}
+
+void test_release_only_click_later_is_a_new_tap() {
+  gesture::Recognizer rec;
+  auto got = run(rec, { at(0, 120, 120, true), at(80, 120, 120, false),
+                        at(600, 120, 120, false, HW_CLICK) }, 1000);
+  expect({ Kind::Press, Kind::Tap, Kind::Release, Kind::Press, Kind::Tap, Kind::Release }, got);
+  TEST_ASSERT_EQUAL_UINT32(2, rec.gestures());
+  TEST_ASSERT_EQUAL_UINT32(0, rec.suppressed());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_tap_then_late_click_id);
+  RUN_TEST(test_tap_then_late_click_id_with_double_tap_window);
+  RUN_TEST(test_swipe_then_late_swipe_id);
+  RUN_TEST(test_release_only_click_later_is_a_new_tap);
+  return UNITY_END();
+}
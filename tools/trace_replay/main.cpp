@@ -0,0 +1,198 @@
+// Replays raw touch traces through the same filter + recognizer the firmware
+// uses and reports how often they were misread.
+//
+//   pio run -e native && .pio/build/native/program [--raw] [--no-hw] traces/*.ktr
+//   g++ -std=c++17 -O2 -Isrc tools/trace_replay/main.cpp src/gesture.cpp -o trace_replay
+//
+// Record traces on the device with POST /api/trace/start and
+// POST /api/trace/stop?name=<label>_<n>, then fetch /traces/<label>_<n>.ktr.
+// The label says what every gesture in the trace was meant to be: tap,
+// double, long, swipe, swipe_left/right/up/down. --synth N replays N
+// generated taps and swipes with controller-like jitter instead of files.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "gesture.hpp"
+#include "touch_filter.hpp"
+
+using gesture::Kind;
+
+namespace {
+
+struct Options { bool raw = false; bool hw = true; };
+
+struct Tally {
+  unsigned gestures = 0, correct = 0, false_tap = 0, false_swipe = 0, wrong = 0, missed = 0;
+  size_t samples = 0;
+  double ns = 0;
+  void add(const Tally& o) {
+    gestures += o.gestures; correct += o.correct; false_tap += o.false_tap; false_swipe += o.false_swipe;
+    wrong += o.wrong; missed += o.missed; samples += o.samples; ns += o.ns;
+  }
+};
+
+bool is_swipe(Kind k) { return k >= Kind::SwipeLeft && k <= Kind::SwipeDown; }
+bool is_tap(Kind k) { return k == Kind::Tap || k == Kind::DoubleTap; }
+
+// Expected event per gesture; SwipeLeft..Down match exactly, `any_swipe` matches all four.
+struct Label { Kind kind = Kind::None; bool any_swipe = false; };
+
+Label label_for(std::string name) {
+  size_t slash = name.find_last_of("/\\");
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  for (auto& c : name) c = (char)tolower(c);
+  auto starts = [&](const char* p) { return name.compare(0, strlen(p), p) == 0; };
+  Label l;
+  if (starts("swipe_left"))       l.kind = Kind::SwipeLeft;
+  else if (starts("swipe_right")) l.kind = Kind::SwipeRight;
+  else if (starts("swipe_up"))    l.kind = Kind::SwipeUp;
+  else if (starts("swipe_down"))  l.kind = Kind::SwipeDown;
+  else if (starts("swipe"))       { l.kind = Kind::SwipeLeft; l.any_swipe = true; }
+  else if (starts("double"))      l.kind = Kind::DoubleTap;
+  else if (starts("long"))        l.kind = Kind::LongPress;
+  else if (starts("tap"))         l.kind = Kind::Tap;
+  return l;
+}
+
+Tally replay(const std::vector<touch::Sample>& trace, Label want, const Options& opt) {
+  gesture::Config cfg;
+  cfg.use_hw = opt.hw;
+  if (want.kind == Kind::DoubleTap) cfg.double_tap_ms = 250;
+  gesture::Recognizer rec(cfg);
+  touch::Filter filter;
+  Tally t;
+
+  // one verdict per finger-down..up; a double tap spans two, so judge on the second
+  std::vector<Kind> got;
+  auto judge = [&](Kind k) {
+    t.gestures++;
+    bool ok = want.any_swipe ? is_swipe(k) : k == want.kind;
+    if (ok) t.correct++;
+    else if (k == Kind::None) t.missed++;
+    else if (is_tap(k) && !is_tap(want.kind)) t.false_tap++;
+    else if (is_swipe(k) && !is_swipe(want.kind)) t.false_swipe++;
+    else t.wrong++;
+  };
+  Kind pending = Kind::None;
+  auto drain = [&]() {
+    gesture::Event ev;
+    while (rec.next(ev)) {
+      if (ev.kind == Kind::Press) { pending = Kind::None; continue; }
+      if (ev.kind == Kind::Release) {
+        if (want.kind == Kind::DoubleTap && pending == Kind::None) continue;   // first half, or tap still held back
+        judge(pending);
+        pending = Kind::None;
+        continue;
+      }
+      if (want.kind == Kind::DoubleTap && ev.kind == Kind::Tap) { judge(Kind::Tap); continue; }
+      pending = ev.kind;
+    }
+  };
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (touch::Sample s : trace) {
+    if (!opt.raw) filter.apply(s);
+    rec.poll(s.t_us);
+    rec.feed(s);
+    drain();
+  }
+  if (!trace.empty()) { rec.poll(trace.back().t_us + 2000000); drain(); }
+  t.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  t.samples = trace.size();
+  return t;
+}
+
+bool load(const char* path, std::vector<touch::Sample>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  char magic[4];
+  bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, touch::kTraceMagic, 4) == 0;
+  uint8_t rec[touch::kTraceRecord];
+  while (ok && fread(rec, 1, sizeof(rec), f) == sizeof(rec)) out.push_back(touch::unpack(rec));
+  fclose(f);
+  return ok;
+}
+
+// Controller-like input: 50 Hz reports, a few px of noise, the odd outlier.
+std::vector<touch::Sample> synth(Kind kind, unsigned n, std::mt19937& rng) {
+  std::normal_distribution<float> jitter(0.0f, 2.5f);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  std::vector<touch::Sample> v;
+  uint32_t t = 0;
+  auto put = [&](float x, float y, bool down) {
+    float ox = u(rng) < 0.05f ? jitter(rng) * 3 : 0, oy = u(rng) < 0.05f ? jitter(rng) * 3 : 0;
+    v.push_back({t, (uint16_t)std::lround(std::fmin(239, std::fmax(0, x + jitter(rng) + ox))),
+                    (uint16_t)std::lround(std::fmin(239, std::fmax(0, y + jitter(rng) + oy))), 0, down});
+  };
+  for (unsigned i = 0; i < n; ++i) {
+    const float x0 = 60 + u(rng) * 120, y0 = 60 + u(rng) * 120;
+    if (kind == Kind::Tap) {
+      const int reports = 2 + (int)(u(rng) * 8);   // 40..180 ms
+      for (int r = 0; r < reports; ++r) { put(x0, y0, true); t += 20000; }
+      put(x0, y0, false);
+    } else {
+      const float len = 50 + u(rng) * 100, ms = 60 + u(rng) * 200;
+      const int reports = (int)(ms / 20) + 1;
+      for (int r = 0; r <= reports; ++r) {
+        const float p = (float)r / reports;
+        put(x0 + 60 - len * p, y0 + jitter(rng), true);
+        t += 20000;
+      }
+      put(x0 + 60 - len, y0, false);
+    }
+    t += 600000;
+  }
+  return v;
+}
+
+void print(const char* name, const Tally& t) {
+  auto pct = [&](unsigned k) { return t.gestures ? 100.0 * k / t.gestures : 0.0; };
+  printf("%-28s %5u gestures  ok %5.1f%%  false-tap %5.1f%%  false-swipe %5.1f%%  wrong %4.1f%%  missed %4.1f%%  %6.0f ns/sample\n",
+         name, t.gestures, pct(t.correct), pct(t.false_tap), pct(t.false_swipe), pct(t.wrong), pct(t.missed),
+         t.samples ? t.ns / t.samples : 0.0);
+}
+
+} // anon
+
+int main(int argc, char** argv) {
+  Options opt;
+  unsigned synthN = 0;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--raw")) opt.raw = true;
+    else if (!strcmp(argv[i], "--no-hw")) opt.hw = false;
+    else if (!strcmp(argv[i], "--synth") && i + 1 < argc) synthN = (unsigned)atoi(argv[++i]);
+    else files.push_back(argv[i]);
+  }
+  if (files.empty() && !synthN) {
+    fprintf(stderr, "usage: %s [--raw] [--no-hw] [--synth N] trace.ktr...\n", argv[0]);
+    return 2;
+  }
+
+  Tally total;
+  if (synthN) {
+    std::mt19937 rng(1234);
+    Label tap{Kind::Tap, false}, swipe{Kind::SwipeLeft, true};
+    Tally a = replay(synth(Kind::Tap, synthN, rng), tap, opt);
+    Tally b = replay(synth(Kind::SwipeLeft, synthN, rng), swipe, opt);
+    print("synthetic taps", a);
+    print("synthetic swipes", b);
+    total.add(a); total.add(b);
+  }
+  for (const char* f : files) {
+    std::vector<touch::Sample> trace;
+    if (!load(f, trace)) { fprintf(stderr, "%s: not a touch trace\n", f); return 1; }
+    Label want = label_for(f);
+    if (want.kind == Kind::None) { fprintf(stderr, "%s: no label (tap_, double_, long_, swipe_...)\n", f); return 1; }
+    Tally t = replay(trace, want, opt);
+    print(f, t);
+    total.add(t);
+  }
+  print(opt.raw ? "total (unfiltered)" : "total", total);
+  return 0;
+}